@@ -0,0 +1,232 @@
+#!/bin/bash
+
+# strict mode
+set -euo pipefail
+IFS=$'\n\t'
+
+#
+# define utility functions
+#
+checks() {
+    local baseline=$1
+
+    # check against baseline unless recording a new one
+    # or checking correctness alone
+    if (( $RECORD == 0 && $TIMING == 1 )); then
+        printf "%s\n" -b "$baseline" -e "$BAND"
+    fi
+}
+
+rerun() {
+    local baseline=$1
+
+    # rerun results are kept apart from baselines
+    echo "$RERUNS/$(basename $baseline)"
+}
+
+keys() {
+    local baseline=$1
+
+    # first value of every record, header excluded
+    tail -n +2 $baseline | cut -d "," -f 1
+}
+
+configurations() {
+    local baseline=$1
+
+    # processors and size of every parallel record, once each;
+    # records with no size are skipped
+    tail -n +2 $baseline | awk -F "," 'NF >= 5 { print $1 "," $5 }' | sort -t "," -k 1,1n -k 2,2n -u
+}
+
+runparallel() {
+    local nproc=$1
+    local dimension=$2
+    local baseline=$3
+    local flags=()
+
+    if (( $nproc > $(nproc) )); then
+        flags=(--oversubscribe)
+    fi
+    mpiexec -np $nproc ${flags[@]+"${flags[@]}"} ${EXTRA_FLAGS[@]+"${EXTRA_FLAGS[@]}"} \
+        ./bin/jacobi-parallel -V -r $REPETITIONS -w $WARMUP $(checks $baseline) $dimension $(rerun $baseline)
+}
+
+check() {
+    local label=$1
+    local start
+    local status=0
+    shift;
+
+    # keep track of failures, go on checking anyway
+    echo -e "\n--- $label" | tee -a $OUTPUT
+    start=$(wc -l < $OUTPUT)
+    "$@" >> $OUTPUT 2>&1 || status=$?
+    tail -n +$(( $start + 1 )) $OUTPUT | grep "^n=" || true
+    if (( $status != 0 )); then
+        echo "FAILED: $label" | tee -a $OUTPUT
+        FAILURES=$(( $FAILURES + 1 ))
+    fi
+}
+
+#
+# check for input parameters
+#
+TIME=$(date "+%Y.%m.%d-%H:%M:%S")
+VERSION=$(cat ./VERSION)
+BASELINES=./data
+REPETITIONS=7
+WARMUP=1
+BAND=0.05
+MAX_DIM=2048
+NPROC_MAX=$(nproc)
+CONVERGING=5,6,7,8
+CONVERGING_THREADS=4
+RECORD=0
+TIMING=1
+FAILURES=0
+IFS=' ' read -r -a EXTRA_FLAGS <<< "${MPIEXEC_FLAGS-}"
+while [[ "${1-0}" =~ ^- && ! "${1-0}" == "--" ]]; do
+    case $1 in
+        ( -B | --baselines )
+            shift;
+            BASELINES=$1
+            ;;
+        ( -r | --repetitions )
+            shift;
+            REPETITIONS=$1
+            ;;
+        ( -e | --band )
+            shift;
+            BAND=$1
+            ;;
+        ( -m | --maxdimension )
+            shift;
+            MAX_DIM=$1
+            ;;
+        ( -n | --nproc )
+            shift;
+            NPROC_MAX=$1
+            ;;
+        ( -R | --record )
+            RECORD=1
+            ;;
+        ( -C | --correctness )
+            TIMING=0
+            ;;
+        ( -v | --version )
+            echo $VERSION
+            exit
+            ;;
+        ( -h | --help)
+            echo "Jacobi MPI $VERSION"
+            echo
+            echo "Reruns configurations recorded in baseline results files and fails"
+            echo "if a parallel solution differs from the serial one or if any"
+            echo "configuration is significantly slower than its baseline."
+            echo
+            echo "Usage: $0 [--baselines <dir>] [--repetitions <r>] [--band <band>] [--maxdimension <dimension>] [--nproc <ranks>] [--record] [--correctness]"
+            echo
+            echo "--baselines or -B: directory of baseline results files (default: $BASELINES)"
+            echo "--repetitions or -r: timed solutions for every configuration (default: $REPETITIONS)"
+            echo "--band or -e: relative noise band over baseline time (default: $BAND)"
+            echo "--maxdimension or -m: skip configurations of larger matrices (default: $MAX_DIM)"
+            echo "--nproc or -n: skip configurations with more ranks (default: $NPROC_MAX)"
+            echo "--record or -R: record baselines on this machine instead of checking them"
+            echo "--correctness or -C: check parallel solutions against serial ones only, not times"
+            echo "--version or -v: print Jacobi MPI version"
+            echo "--help or -h: print this program guide"
+            echo
+            echo "Extra mpiexec flags can be given in MPIEXEC_FLAGS environment variable."
+            exit
+            ;;
+        ( * )
+            echo "Invalid parameter specified!"
+            exit 1
+            ;;
+    esac;
+    shift;
+done
+
+SERIAL=$BASELINES/results-serial.csv
+STRONG=$BASELINES/results-parallel-s.csv
+WEAK=$BASELINES/results-parallel-w.csv
+for BASELINE in $SERIAL $STRONG $WEAK; do
+    if [[ ! -e $BASELINE ]]; then
+        echo "Missing baseline $BASELINE!"
+        exit 1
+    fi
+done
+
+#
+# build binaries if they don't already exist
+#
+if [[ ! -e ./log ]]; then
+    mkdir log
+fi
+OUTPUT=./log/check-regression.log
+echo -e "\n\t#####\n" >> $OUTPUT
+echo "[$TIME] Checking Jacobi MPI $VERSION against $BASELINES" >> $OUTPUT
+if [[ ! -e ./bin/jacobi-serial || ! -e ./bin/jacobi-parallel || ! -e ./bin/jacobi-threads ]]; then
+    echo "Building binaries..." | tee -a $OUTPUT
+    mkdir -p bin
+    make jacobiutils jacobi-serial jacobi-parallel jacobi-threads >> $OUTPUT
+fi
+RERUNS=$(mktemp -d)
+trap 'rm -rf $RERUNS' EXIT
+
+#
+# serial baseline, keyed by dimension
+#
+DIMENSIONS=""
+for DIMENSION in $(keys $SERIAL); do
+    if (( $DIMENSION <= $MAX_DIM )); then
+        DIMENSIONS="${DIMENSIONS:+$DIMENSIONS,}$DIMENSION"
+    fi
+done
+if [[ -n $DIMENSIONS ]]; then
+    check "serial $DIMENSIONS" ./bin/jacobi-serial -r $REPETITIONS -w $WARMUP \
+        $(checks $SERIAL) $DIMENSIONS $(rerun $SERIAL)
+fi
+
+#
+# parallel baselines, keyed by number of processors and dimension
+#
+for CONFIGURATION in $(configurations $STRONG); do
+    NPROC=${CONFIGURATION%,*}
+    DIMENSION=${CONFIGURATION#*,}
+    if (( $NPROC <= $NPROC_MAX && $DIMENSION <= $MAX_DIM )); then
+        check "strong np=$NPROC n=$DIMENSION" runparallel $NPROC $DIMENSION $STRONG
+    fi
+done
+for CONFIGURATION in $(configurations $WEAK); do
+    NPROC=${CONFIGURATION%,*}
+    DIMENSION=${CONFIGURATION#*,}
+    if (( $NPROC <= $NPROC_MAX && $DIMENSION <= $MAX_DIM )); then
+        check "weak np=$NPROC n=$DIMENSION" runparallel $NPROC $DIMENSION $WEAK
+    fi
+done
+
+#
+# multithreaded solution stopping early, on grids small enough
+# to converge before the iteration limit, with no baseline
+#
+check "threads converging t=$CONVERGING_THREADS n=$CONVERGING" ./bin/jacobi-threads -V \
+    -t $CONVERGING_THREADS -r $REPETITIONS $CONVERGING $RERUNS/results-threads.csv
+echo -e "\n\t#####" >> $OUTPUT
+
+if (( $RECORD == 1 )); then
+    for BASELINE in $SERIAL $STRONG $WEAK; do
+        # last record of a configuration wins, so
+        # configurations not rerun keep their baseline
+        if [[ -e $(rerun $BASELINE) ]]; then
+            cat $(rerun $BASELINE) >> $BASELINE
+        fi
+    done
+    echo -e "\nBaselines recorded in $BASELINES"
+fi
+if (( $FAILURES > 0 )); then
+    echo -e "\n$FAILURES configurations failed, see $OUTPUT"
+    exit 1
+fi
+echo -e "\nNo regression detected."
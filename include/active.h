@@ -0,0 +1,52 @@
+/**
+ * @file active.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for active-set Jacobi method skipping settled tiles.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef ACTIVE_H_
+#define ACTIVE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Rows and columns of inner cells of a tile.
+ */
+static const int ACTIVE_TILE = 128;
+/**
+ * @brief Fraction of `CONVERGENCE_THRESHOLD` below which the update of
+ * a tile freezes it.
+ */
+static const double ACTIVE_FRACTION = 0.1;
+/**
+ * @brief Iterations between rechecks of a frozen tile.
+ */
+static const int ACTIVE_RECHECK = 10;
+
+/**
+ * @brief Figures of an active-set solution.
+ *
+ * Figures of an active-set solution.
+ */
+struct active_stats {
+    double updated;  /**< Cell updates computed */
+    double skipped;  /**< Cell updates skipped, tiles being frozen */
+    int tiles;       /**< Number of tiles */
+    int frozen;      /**< Tiles frozen at the end */
+    int woken;       /**< Frozen tiles swept again as a neighbour changed */
+};
+
+int jacobi_active(double *, int, int, double *, struct active_stats *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ACTIVE_H_
@@ -0,0 +1,36 @@
+/**
+ * @file bands.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for multithreaded Jacobi method over row bands.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef BANDS_H_
+#define BANDS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Figures of a multithreaded solution.
+ *
+ * Figures of a multithreaded solution.
+ */
+struct bands_stats {
+    int threads;         /**< Threads actually used */
+    int wasted;          /**< Most iterations a thread ran past convergence */
+    double wait_seconds; /**< Most time a thread spent waiting for others */
+};
+
+int bands_jacobi(double *, int, int, double *, struct bands_stats *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BANDS_H_
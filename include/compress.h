@@ -0,0 +1,62 @@
+/**
+ * @file compress.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for ghost row compression.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef COMPRESS_H_
+#define COMPRESS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ghost row compression modes.
+ *
+ * Ghost row compression modes.
+ */
+enum compress_mode {
+    COMPRESS_NONE,     /**< Rows are sent as they are */
+    COMPRESS_LOSSLESS, /**< XOR delta against previous row, byte planes, RLE */
+    COMPRESS_LOSSY,    /**< Quantized delta against receiver row, byte planes, RLE */
+    COMPRESS_COUNT     /**< Number of modes */
+};
+
+extern const char *COMPRESS_NAMES[COMPRESS_COUNT];
+
+/**
+ * @brief Ghost row codec of a given row length.
+ *
+ * Ghost row codec of a given row length; both ends of a link keep a
+ * reference row, which must start equal and is updated by every
+ * compressed and expanded row.
+ */
+struct compress {
+    enum compress_mode mode; /**< Compression mode */
+    int n;                   /**< Row length */
+    double quantum;          /**< Quantization step of lossy mode */
+    uint64_t *words;         /**< Row deltas as 64 bit words */
+    unsigned char *planes;   /**< Row deltas as byte planes */
+};
+
+int compress_parse(char *);
+void compress_create(struct compress *, enum compress_mode, int);
+size_t compress_bound(int);
+size_t compress_row(struct compress *, double *, double *, unsigned char *);
+int expand_row(struct compress *, unsigned char *, size_t, double *, double *);
+void compress_free(struct compress *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COMPRESS_H_
@@ -0,0 +1,54 @@
+/**
+ * @file csr.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for Jacobi method over sparse matrices in CSR format.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef CSR_H_
+#define CSR_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Off-diagonal entries drawn for every row of a generated matrix.
+ */
+static const int SPARSE_NEIGHBOURS = 6;
+
+/**
+ * @brief Sparse matrix in compressed sparse row format.
+ *
+ * Sparse matrix in compressed sparse row format; columns of every row
+ * are sorted.
+ */
+struct csr {
+    int rows;        /**< Number of rows */
+    int cols;        /**< Number of columns */
+    size_t nnz;      /**< Number of nonzeros */
+    size_t *row_ptr; /**< First entry of every row, `rows + 1` long */
+    int *col;        /**< Column of every entry */
+    double *val;     /**< Value of every entry */
+};
+
+void csr_generate(struct csr *, int, double, double, int);
+int csr_read(struct csr *, const char *);
+void csr_product(struct csr *, double *, double *);
+void csr_system(struct csr *, double *, double, double, int);
+int csr_inverse_diagonal(struct csr *, double *);
+double csr_sweep(struct csr *, double *, double *, double *, double *, int *, int);
+int jacobi_sparse(struct csr *, double *, double *, double *);
+void csr_free(struct csr *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CSR_H_
@@ -0,0 +1,59 @@
+/**
+ * @file dense.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for parallel Jacobi method over dense systems.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef DENSE_H_
+#define DENSE_H_
+
+#include "mpi.h"
+#include "phases.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Row block of a dense system Ax=b owned by a process.
+ *
+ * Row block of a dense system owned by a process, along with the whole
+ * solution, replicated on every process, and the row distribution.
+ */
+struct dense {
+    MPI_Comm comm;           /**< Communicator of processes sharing the system */
+    int nproc;               /**< Number of processes */
+    int me;                  /**< Rank of this process */
+    int n;                   /**< Order of the system */
+    int *rowcounts;          /**< Rows of every process */
+    int *rowdispls;          /**< First row of every process */
+    size_t *sendcounts;      /**< Scatter counts of matrix */
+    size_t *senddispls;      /**< Scatter displacements of matrix */
+    int local_rows;          /**< Rows of this process */
+    int first_row;           /**< Global index of first row of this process */
+    double *local_A;         /**< Local rows of matrix */
+    double *local_b;         /**< Local known terms */
+    double *inv_diag;        /**< Inverse diagonal of local rows */
+    double *x;               /**< Whole solution */
+    double *x_new;           /**< Local solution after iteration */
+    int max_iterations;      /**< Iterations allowed before giving up */
+    int num_iterations;      /**< Iterations of last solution */
+    double diffnorm;         /**< Error of last solution */
+    struct phases *phases;   /**< Phase accumulators */
+};
+
+void dense_create(struct dense *, MPI_Comm, int, struct phases *);
+void dense_scatter(struct dense *, double *, double *);
+void dense_iterate(struct dense *);
+void dense_free(struct dense *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DENSE_H_
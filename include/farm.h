@@ -0,0 +1,70 @@
+/**
+ * @file farm.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for task farm of independent grid solutions.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef FARM_H_
+#define FARM_H_
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Figures recorded for every job: order, group, iterations,
+ * error and time.
+ */
+static const int FARM_FIELDS = 5;
+
+/**
+ * @brief A grid to solve.
+ */
+struct farm_job {
+    int n;    /**< Matrix order */
+    int seed; /**< Seed of generated matrix */
+};
+
+/**
+ * @brief Groups of processes solving jobs as they get free.
+ *
+ * Groups of processes solving jobs as they get free: the leader of a
+ * group takes the next job from a counter held by MASTER, through
+ * `MPI_Fetch_and_op`, and hands it to the rest of the group.
+ */
+struct farm {
+    MPI_Comm comm;      /**< Communicator of every process */
+    MPI_Comm group;     /**< Communicator of processes of this group */
+    int group_id;       /**< Index of this group */
+    int group_count;    /**< Number of groups */
+    int group_size;     /**< Processes of this group */
+    int leader;         /**< Whether this process leads its group */
+    MPI_Win next_win;   /**< Window of next job counter */
+    int *next;          /**< Next job counter (on MASTER only) */
+    struct farm_job *jobs; /**< Jobs to solve */
+    int job_count;      /**< Number of jobs */
+    double *records;    /**< `FARM_FIELDS` figures of every job solved by this group */
+    int done;           /**< Jobs solved by this group */
+    double busy;        /**< Seconds spent by this group on jobs */
+    double seconds;     /**< Seconds from first job taken to last one solved */
+    int failed;         /**< Whether a solution differs from serial one */
+};
+
+int farm_read(const char *, struct farm_job **);
+void farm_create(struct farm *, MPI_Comm, int, struct farm_job *, int);
+void farm_run(struct farm *, int, int, unsigned char);
+int farm_report(struct farm *, const char *);
+void farm_free(struct farm *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FARM_H_
@@ -0,0 +1,88 @@
+/**
+ * @file halo.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for ghost rows exchange backends.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef HALO_H_
+#define HALO_H_
+
+#include "mpi.h"
+#include "compress.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ghost rows exchange backends.
+ *
+ * Ghost rows exchange backends.
+ */
+enum halo_backend {
+    HALO_SENDRECV, /**< A couple of `MPI_Sendrecv` calls */
+    HALO_SHM,      /**< Direct copy from on-node neighbours via shared memory */
+    HALO_RMA,      /**< `MPI_Put` into neighbour ghost rows, PSCW synchronization */
+    HALO_NEIGHBOR, /**< `MPI_Neighbor_alltoallw` over a Cartesian topology */
+    HALO_COUNT     /**< Number of backends */
+};
+
+extern const char *HALO_NAMES[HALO_COUNT];
+
+/**
+ * @brief Ghost rows exchange state of a process.
+ *
+ * Ghost rows exchange state of a process; it owns the ghosted submatrix
+ * after iteration, since some backends need it in a window.
+ */
+struct halo {
+    enum halo_backend backend; /**< Exchange backend */
+    MPI_Comm comm;             /**< Communicator of processes sharing the matrix */
+    int me;                    /**< Rank of this process */
+    int n;                     /**< Matrix order */
+    int up;                    /**< Previous process, MPI_PROC_NULL for first one */
+    int down;                  /**< Next process, MPI_PROC_NULL for last one */
+    size_t first_g_row;        /**< Index of first unghosted row */
+    size_t last_g_row;         /**< Index of last unghosted row */
+    size_t last_local_row;     /**< Index of last ghosted row */
+    double *prime;             /**< Local ghosted submatrix after iteration */
+    unsigned char debug;       /**< Debug flag */
+    MPI_Comm node;             /**< Processes sharing memory with this one */
+    MPI_Win data_win;          /**< Window of submatrices after iteration */
+    MPI_Win flag_win;          /**< Shared window of synchronization flags */
+    double *up_row;            /**< Last unghosted row of previous process, if on node */
+    double *down_row;          /**< First unghosted row of next process, if on node */
+    volatile int *flags;       /**< Flags of this process */
+    volatile int *up_flags;    /**< Flags of previous process, if on node */
+    volatile int *down_flags;  /**< Flags of next process, if on node */
+    int epoch;                 /**< Exchanges performed so far */
+    MPI_Group neighbours;      /**< Previous and next process, for RMA epochs */
+    MPI_Aint up_ghost;         /**< Last ghost row offset in previous process window */
+    struct compress codec;     /**< Codec of rows sent as messages */
+    double *sent[2];           /**< Codec references of rows sent up and down */
+    double *received[2];       /**< Codec references of rows received from up and down */
+    unsigned char *packed;     /**< Compressed row to send */
+    unsigned char *unpacked;   /**< Compressed row received */
+    double raw_bytes;          /**< Bytes of rows sent as messages */
+    double packed_bytes;       /**< Bytes actually sent for them */
+};
+
+int halo_parse(char *);
+void halo_create(struct halo *, MPI_Comm, int, size_t *, enum halo_backend, unsigned char);
+void halo_compress(struct halo *, enum compress_mode);
+void halo_exchange(struct halo *);
+int halo_on_node(struct halo *);
+void halo_free(struct halo *);
+void halo_topology(MPI_Comm, int, MPI_Comm *);
+double halo_probe(MPI_Comm, int, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HALO_H_
@@ -13,6 +13,8 @@
 #ifndef JACOBI_H_
 #define JACOBI_H_
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,19 +27,43 @@ static const short MAX_ITERATIONS = 1E2; // 100
  * @brief Minimum error required to Jacobi method.
  */
 static const double CONVERGENCE_THRESHOLD = 1E-2; // 0.01
+/**
+ * @brief Columns of a dense row swept at once, so that their slice of
+ * the unknowns stays in L1 cache (8 KiB).
+ */
+static const int DENSE_BLOCK = 1024;
+
+/**
+ * @brief Problems solved by Jacobi method.
+ *
+ * Problems solved by Jacobi method.
+ */
+enum jacobi_mode {
+    JACOBI_GRID,      /**< Laplace equation over a grid */
+    JACOBI_DENSE,     /**< Dense diagonally dominant system Ax=b */
+    JACOBI_SPARSE,    /**< Sparse system Ax=b */
+    JACOBI_ACTIVE,    /**< Laplace equation, skipping settled tiles */
+    JACOBI_MODE_COUNT /**< Number of modes */
+};
 
+extern const char *JACOBI_MODE_NAMES[JACOBI_MODE_COUNT];
+
+int jacobi_mode_parse(char *);
 int jacobi(double *, int, int, double *);
+int jacobi_dense(double *, double *, double *, int, double *);
+double dense_sweep(double *, double *, double *, double *, double *, int, int, int);
+void inverse_diagonal(double *, double *, int, int, int);
 void jacobi_iteration(double *, double *, int, int);
 void swap_pointers(void **, void **);
 void replace_elements(double *, double *, int, int);
-void replace_partial(double *, double *, int, int, int, int);
+void replace_partial(double *, double *, int, size_t, size_t, int);
 double convergence_check_g(double *, double *, int, int);
 double convergence_check(double *, double *, int, int);
 void scatterv_gatherv_describers(
-    int *,
-    int *,
-    int *,
-    int *,
+    size_t *,
+    size_t *,
+    size_t *,
+    size_t *,
     int *,
     int,
     int,
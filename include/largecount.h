@@ -0,0 +1,69 @@
+/**
+ * @file largecount.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for collective transfers past `int` counts.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef LARGECOUNT_H_
+#define LARGECOUNT_H_
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief MPI datatype matching `size_t`.
+ */
+#ifndef MPI_SIZE_T
+#if SIZE_MAX == UINT64_MAX
+#define MPI_SIZE_T MPI_UINT64_T
+#else
+#define MPI_SIZE_T MPI_UINT32_T
+#endif
+#endif
+
+/**
+ * @brief Largest count or displacement an `int` based call takes.
+ */
+static const size_t LARGE_COUNT_LIMIT = INT_MAX;
+/**
+ * @brief Elements of a contiguous chunk, when transfers past
+ * `LARGE_COUNT_LIMIT` are split into derived datatypes.
+ */
+static const int LARGE_CHUNK = 1 << 30;
+
+void scatterv_large(
+    void *,
+    size_t *,
+    size_t *,
+    MPI_Datatype,
+    void *,
+    int,
+    MPI_Comm
+);
+void gatherv_large(
+    void *,
+    void *,
+    size_t *,
+    size_t *,
+    MPI_Datatype,
+    int,
+    MPI_Comm
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LARGECOUNT_H_
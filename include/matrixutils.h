@@ -28,6 +28,12 @@ void generate_matrix_array(double *, int, int, double, double, int);
  * Generate a dominant diagonal matrix as array.
  */
 void generate_dd_matrix_array(double *, int, int, double, double, int);
+/**
+ * @brief Generate a dominant diagonal system Ax=b with known solution.
+ * 
+ * Generate a dominant diagonal system Ax=b with known solution.
+ */
+void generate_dd_system(double *, double *, int, double, double, int);
 /**
  * @brief Print an array matrix.
  * 
@@ -46,6 +52,18 @@ void copy_matrix_array(double *, double *, int, int);
  * Array matrix-vector dot product.
  */
 void prod_mat_vett(double *, double *, int, int, double *);
+/**
+ * @brief Array matrix product with several vectors at once.
+ * 
+ * Array matrix product with several vectors at once.
+ */
+void prod_mat_multi_vett(double *, double *, int, int, double *, int);
+/**
+ * @brief Number of threads sharing a matrix product.
+ * 
+ * Number of threads sharing a matrix product.
+ */
+int matvec_threads(int, int);
 /**
  * @brief Transpose an array matrix.
  * 
@@ -23,13 +23,13 @@ extern "C" {
  * 
  * Default master (processor 0) in MPI cluster.
  */
-static int MASTER = 0;
+static const int MASTER = 0;
 /**
  * @brief Default tag for MPI 1-to-1 communications.
  * 
  * Default tag for MPI 1-to-1 communications.
  */
-static int TAG = 1;
+static const int TAG = 1;
 
 //void MPI_Pause(int, int, MPI_Comm);
 void MPI_Printf(int, char *);
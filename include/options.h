@@ -0,0 +1,62 @@
+/**
+ * @file options.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for command-line options parsing.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef OPTIONS_H_
+#define OPTIONS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Command-line options shared by Jacobi binaries.
+ *
+ * Command-line options shared by Jacobi binaries; every binary accepts
+ * the subset of options given in its `getopt` option string.
+ */
+struct options {
+    int *sizes;             /**< Matrix orders to solve */
+    int size_count;         /**< Number of matrix orders */
+    char *output_file;      /**< Results file name */
+    unsigned char debug;    /**< Debug flag */
+    unsigned char counters; /**< Hardware counters and roofline report */
+    int repetitions;        /**< Timed solutions for every matrix order */
+    int warmup;             /**< Untimed solutions for every matrix order */
+    unsigned char verify;   /**< Check solution against serial one */
+    char *baseline_file;    /**< Baseline results file to check against */
+    double band;            /**< Relative noise band over baseline time */
+    char *halo;             /**< Ghost rows exchange backend name */
+    char *grid_file;        /**< Grid file for out-of-core solution */
+    int fused;              /**< Iterations fused in an out-of-core pass */
+    char *compress;         /**< Ghost row compression mode name */
+    char *snapshot_prefix;  /**< Snapshot files prefix, NULL for none */
+    int snapshot_every;     /**< Iterations between field snapshots */
+    int snapshot_stride;    /**< Rows and columns between sampled elements */
+    unsigned char autotune; /**< Search fastest configuration before solving */
+    char *tune_file;        /**< Tuning cache file, NULL for default one */
+    char *mode;             /**< Problem mode name, NULL for grid */
+    char *matrix_file;      /**< MatrixMarket file of sparse matrix, NULL to generate it */
+    unsigned char placement; /**< Rank processes anew by locality */
+    int threads;            /**< Threads, 0 for one per online CPU */
+    char *trace_file;       /**< Chrome trace file, NULL for no tracing */
+    unsigned char autoranks; /**< Solve over as many processes as predicted fastest */
+    char *job_file;         /**< Task farm job file, NULL for no task farm */
+    int group_size;         /**< Processes of every task farm group */
+};
+
+int parse_options(int, char **, const char *, struct options *);
+void free_options(struct options *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPTIONS_H_
@@ -0,0 +1,49 @@
+/**
+ * @file outofcore.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for out-of-core Jacobi method.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef OUTOFCORE_H_
+#define OUTOFCORE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of iterations fused in a pass over the grid.
+ */
+static const int FUSED_ITERATIONS = 8;
+
+/**
+ * @brief Bytes of grid read at once from file.
+ */
+static const long BAND_BYTES = 4L << 20; // 4 MiB
+
+/**
+ * @brief Figures of an out-of-core solution.
+ *
+ * Figures of an out-of-core solution.
+ */
+struct ooc_stats {
+    int passes;           /**< Passes over the grid, redone ones included */
+    int redone;           /**< Passes redone to stop at convergence */
+    double bytes_read;    /**< Bytes read from files */
+    double bytes_written; /**< Bytes written to files */
+    double window;        /**< Bytes of rolling window and band buffers */
+};
+
+int ooc_generate(char *, int, double, double, int);
+int ooc_jacobi(char *, char *, int, int, double *, struct ooc_stats *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OUTOFCORE_H_
@@ -0,0 +1,68 @@
+/**
+ * @file perfcounters.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for hardware counters and roofline report.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Instrumented kernels.
+ *
+ * Instrumented kernels.
+ */
+enum kernel {
+    KERNEL_SWEEP,    /**< jacobi_iteration */
+    KERNEL_RESIDUAL, /**< convergence_check_g */
+    KERNEL_COPY,     /**< replace_elements, replace_partial */
+    KERNEL_COUNT     /**< Number of kernels */
+};
+
+/**
+ * @brief Hardware events counted for every kernel.
+ *
+ * Hardware events counted for every kernel.
+ */
+enum counter {
+    COUNTER_CYCLES,       /**< CPU cycles */
+    COUNTER_INSTRUCTIONS, /**< Retired instructions */
+    COUNTER_LLC_MISSES,   /**< Last level cache misses */
+    COUNTER_COUNT         /**< Number of events */
+};
+
+/**
+ * @brief Counter values and timings accumulated per kernel.
+ *
+ * Counter values and timings accumulated per kernel.
+ */
+struct kernel_counters {
+    unsigned long long value[KERNEL_COUNT][COUNTER_COUNT]; /**< Events */
+    unsigned long long calls[KERNEL_COUNT];  /**< Kernel invocations */
+    double cells[KERNEL_COUNT];              /**< Updated cells */
+    double seconds[KERNEL_COUNT];            /**< Time spent in kernel */
+    int available[COUNTER_COUNT];            /**< Whether event was counted */
+};
+
+int counters_open(void);
+void counters_close(void);
+void counters_begin(void);
+void counters_end(enum kernel, double);
+struct kernel_counters *counters_get(void);
+double stream_triad_bandwidth(int);
+void counters_report(struct kernel_counters *, double);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERFCOUNTERS_H_
@@ -0,0 +1,63 @@
+/**
+ * @file perfmodel.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for cost model of parallel grid solution.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef PERFMODEL_H_
+#define PERFMODEL_H_
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Order of the grid swept to calibrate per-cell time.
+ */
+static const int PERFMODEL_ORDER = 256;
+/**
+ * @brief Sweeps, round trips and reductions timed by calibration.
+ */
+static const int PERFMODEL_ROUNDS = 50;
+/**
+ * @brief Doubles in the large message of a calibration round trip.
+ */
+static const int PERFMODEL_MESSAGE = 8192;
+
+/**
+ * @brief Latency-bandwidth model of a parallel grid solution.
+ *
+ * Latency-bandwidth model of a parallel grid solution, whose figures
+ * are measured on the machine the solution runs on.
+ */
+struct perfmodel {
+    double cell;       /**< Seconds per cell of an iteration, one process sweeping */
+    double cell_busy;  /**< Seconds per cell of an iteration, every process sweeping */
+    double latency;    /**< Seconds per message */
+    double byte;       /**< Seconds per byte of message */
+    double stage;      /**< Seconds per stage of a reduction */
+    int nproc;         /**< Processes calibration ran over */
+};
+
+int perfmodel_stages(int);
+double perfmodel_cell_time(void);
+double perfmodel_round_trip(MPI_Comm, int, double *);
+double perfmodel_reduction(MPI_Comm);
+void perfmodel_fit(int, double *, double *, double *, double *);
+void perfmodel_calibrate(struct perfmodel *, MPI_Comm, int, int *, double *);
+double perfmodel_iteration(struct perfmodel *, int, int);
+double perfmodel_solution(struct perfmodel *, int, int, int);
+int perfmodel_ranks(struct perfmodel *, int, int, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERFMODEL_H_
@@ -0,0 +1,81 @@
+/**
+ * @file phases.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for per-phase timing functions.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef PHASES_H_
+#define PHASES_H_
+
+#include "mpi.h"
+#include "trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Phases of a parallel Jacobi execution.
+ *
+ * Phases of a parallel Jacobi execution.
+ */
+enum phase {
+    PHASE_STARTUP,   /**< Argument parsing, generation and setup */
+    PHASE_SCATTER,   /**< Distribution of submatrices */
+    PHASE_SWEEP,     /**< Jacobi iteration over local submatrix */
+    PHASE_RESIDUAL,  /**< Local convergence check */
+    PHASE_ALLREDUCE, /**< Global convergence reduction */
+    PHASE_BARRIER,   /**< Barrier before row exchange */
+    PHASE_EXCHANGE,  /**< Ghost rows exchange */
+    PHASE_COPY,      /**< Copy back of prime submatrix */
+    PHASE_SNAPSHOT,  /**< Residual and field hand-over to snapshot writer */
+    PHASE_GATHER,    /**< Unghosting and recollection of submatrices */
+    PHASE_COUNT      /**< Number of phases */
+};
+
+/**
+ * @brief Per-rank phase time accumulators.
+ *
+ * Per-rank phase time accumulators; time is accumulated in laps, so
+ * only one `MPI_Wtime` call is needed for each phase.
+ */
+struct phases {
+    double elapsed[PHASE_COUNT]; /**< Accumulated seconds per phase */
+    double mark;                 /**< Timestamp of last lap */
+    struct trace *trace;         /**< Timeline every lap goes into, NULL for none */
+};
+
+/**
+ * @brief Phase times reduced over all ranks.
+ *
+ * Phase times reduced over all ranks.
+ */
+struct phase_stats {
+    int n;                    /**< Matrix order */
+    int nproc;                /**< Number of processes */
+    double min[PHASE_COUNT];  /**< Minimum time among ranks */
+    double avg[PHASE_COUNT];  /**< Average time among ranks */
+    double max[PHASE_COUNT];  /**< Maximum time among ranks */
+};
+
+extern const char *PHASE_NAMES[PHASE_COUNT];
+
+void phases_reset(struct phases *);
+void phases_start(struct phases *);
+void phases_lap(struct phases *, enum phase);
+void phases_discard(struct phases *);
+void phases_reduce(struct phases *, struct phase_stats *, int, int, MPI_Comm);
+double phases_imbalance(struct phase_stats *, enum phase);
+void phases_print(struct phase_stats *);
+int phases_write(char *, struct phase_stats *, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PHASES_H_
@@ -0,0 +1,55 @@
+/**
+ * @file placement.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for locality-aware rank placement.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef PLACEMENT_H_
+#define PLACEMENT_H_
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Where a process runs.
+ *
+ * Where a process runs: node is the lowest rank sharing memory with
+ * it, socket and CPU are the ones it is running on at discovery, -1
+ * when unknown.
+ */
+struct locality {
+    int node;   /**< Lowest rank on same node */
+    int socket; /**< Physical package of CPU */
+    int cpu;    /**< CPU the process runs on */
+};
+
+/**
+ * @brief Neighbour links of the rank chain by locality.
+ *
+ * Neighbour links of the rank chain, i.e. pairs of ranks i and i+1
+ * exchanging ghost rows, by locality.
+ */
+struct placement_links {
+    int nodes;     /**< Number of nodes */
+    int links;     /**< Neighbour links */
+    int on_node;   /**< Links within a node */
+    int on_socket; /**< Links within a socket */
+};
+
+void placement_discover(MPI_Comm, struct locality *);
+void placement_links(MPI_Comm, struct placement_links *);
+void placement_reorder(MPI_Comm, MPI_Comm *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLACEMENT_H_
@@ -0,0 +1,57 @@
+/**
+ * @file regress.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for correctness and performance regression checks.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef REGRESS_H_
+#define REGRESS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default relative noise band over baseline median time.
+ */
+static const double NOISE_BAND = 5E-2; // 5%
+/**
+ * @brief Significance level of regression sign test.
+ */
+static const double SIGNIFICANCE = 5E-2;
+/**
+ * @brief Maximum absolute difference from serial solution.
+ */
+static const double VERIFY_TOLERANCE = 1E-9;
+
+/**
+ * @brief Outcome of a regression check against a baseline.
+ *
+ * Outcome of a regression check against a baseline.
+ */
+struct regression {
+    double baseline;  /**< Baseline median time */
+    double threshold; /**< Baseline median time plus noise band */
+    double median;    /**< Median time of current samples */
+    int exceeding;    /**< Samples slower than threshold */
+    int samples;      /**< Number of samples */
+    double p_value;   /**< One-sided sign test p-value */
+    int regressed;    /**< Whether slowdown is significant */
+};
+
+int baseline_median(char *, int, int, double *);
+double sign_test(int, int);
+void check_regression(double *, int, double, double, struct regression *);
+void regression_print(char *, struct regression *, double);
+int verify_solution(double *, double *, int, int, double, double *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REGRESS_H_
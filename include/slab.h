@@ -0,0 +1,72 @@
+/**
+ * @file slab.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for parallel Jacobi method over row slabs.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SLAB_H_
+#define SLAB_H_
+
+#include "mpi.h"
+#include "halo.h"
+#include "phases.h"
+#include "snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ghosted row slab of a matrix owned by a process.
+ *
+ * Ghosted row slab of a matrix owned by a process, along with
+ * scatter/gather describers of the whole matrix.
+ */
+struct slab {
+    MPI_Comm comm;           /**< Communicator of processes sharing the matrix */
+    int nproc;               /**< Number of processes */
+    int me;                  /**< Rank of this process */
+    int n;                   /**< Matrix order */
+    size_t *sendcounts;      /**< Scatter counts */
+    size_t *senddispls;      /**< Scatter displacements */
+    size_t *recvcounts;      /**< Gather counts */
+    size_t *recvdispls;      /**< Gather displacements */
+    int local_rows;          /**< Unghosted rows */
+    int local_g_rows;        /**< Ghosted rows */
+    size_t first_g_row;      /**< Index of first unghosted row */
+    size_t last_g_row;       /**< Index of last unghosted row */
+    size_t last_local_row;   /**< Index of last ghosted row */
+    double *local_A_g;       /**< Local ghosted submatrix */
+    double *local_A_g_prime; /**< Local ghosted submatrix after iteration */
+    int max_iterations;      /**< Iterations allowed before giving up */
+    int num_iterations;      /**< Iterations of last solution */
+    double diffnorm;         /**< Error of last solution */
+    unsigned char debug;     /**< Debug flag */
+    struct phases *phases;   /**< Phase accumulators */
+    struct halo halo;        /**< Ghost rows exchange */
+    struct snapshot *snapshot; /**< Snapshots to take, NULL for none */
+};
+
+void slab_create(
+    struct slab *,
+    MPI_Comm,
+    int,
+    unsigned char,
+    struct phases *,
+    enum halo_backend
+);
+void slab_scatter(struct slab *, double *);
+void slab_iterate(struct slab *);
+void slab_gather(struct slab *, double *);
+void slab_free(struct slab *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SLAB_H_
@@ -0,0 +1,72 @@
+/**
+ * @file snapshot.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for in-situ snapshots written in background.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default iterations between field snapshots.
+ */
+static const int SNAPSHOT_EVERY = 10;
+
+/**
+ * @brief Snapshots of a process, handed over to a writer thread.
+ *
+ * Snapshots of a process: the solver copies residuals and sampled rows
+ * into staging buffers, the writer thread owns a buffer while its
+ * `pending` flag is set.
+ */
+struct snapshot {
+    char *prefix;            /**< Snapshot files prefix */
+    int n;                   /**< Matrix order */
+    int rank;                /**< Rank of this process */
+    int every;               /**< Iterations between field snapshots */
+    int stride;              /**< Rows and columns between sampled elements */
+    int first_row;           /**< Global index of first sampled row */
+    int rows;                /**< Sampled rows */
+    int cols;                /**< Sampled columns */
+    int local_first;         /**< Local index of first sampled row */
+    double *field;           /**< Staged sampled rows */
+    int field_iteration;     /**< Iteration of staged rows */
+    int field_pending;       /**< Whether staged rows are being written */
+    double *history;         /**< Residual of every iteration so far */
+    int history_count;       /**< Iterations in residual history */
+    double *history_out;     /**< Staged residual history */
+    int history_out_count;   /**< Iterations in staged residual history */
+    int history_pending;     /**< Whether staged history is being written */
+    int taken;               /**< Field snapshots written */
+    int dropped;             /**< Field snapshots dropped, writer being busy */
+    double write_seconds;    /**< Time spent by writer thread */
+    int failed;              /**< Whether a file could not be written */
+    int quit;                /**< Whether writer thread has to exit */
+    pthread_t writer;        /**< Writer thread */
+    pthread_mutex_t lock;    /**< Lock of pending flags */
+    pthread_cond_t wake;     /**< Something to write or quit */
+    pthread_cond_t idle;     /**< Something written */
+};
+
+void snapshot_create(struct snapshot *, char *, int, int, int, int, int, int);
+void snapshot_residual(struct snapshot *, int, double);
+void snapshot_field(struct snapshot *, int, double *, int);
+void snapshot_flush(struct snapshot *);
+void snapshot_free(struct snapshot *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAPSHOT_H_
@@ -0,0 +1,77 @@
+/**
+ * @file sparse.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for parallel Jacobi method over sparse systems.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef SPARSE_H_
+#define SPARSE_H_
+
+#include "mpi.h"
+#include "csr.h"
+#include "phases.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Row partition of a sparse system Ax=b owned by a process.
+ *
+ * Row partition of a sparse system owned by a process. Columns of
+ * local rows are numbered with owned rows first, then ghost entries,
+ * i.e. entries of the solution owned by other processes, grouped by
+ * owner; the exchange pattern of ghost entries is built once.
+ */
+struct sparse {
+    MPI_Comm comm;           /**< Communicator of processes sharing the system */
+    int nproc;               /**< Number of processes */
+    int me;                  /**< Rank of this process */
+    int n;                   /**< Order of the system */
+    int *rowdispls;          /**< First row of every process, then order */
+    int *rowcounts;          /**< Rows of every process */
+    int local_rows;          /**< Rows of this process */
+    int first_row;           /**< Global index of first row of this process */
+    struct csr local;        /**< Local rows, with local column numbering */
+    double *local_b;         /**< Local known terms */
+    double *inv_diag;        /**< Inverse diagonal of local rows */
+    double *x;               /**< Owned entries, then ghost entries of solution */
+    double *x_new;           /**< Owned entries of solution after iteration */
+    int ghosts;              /**< Ghost entries */
+    int *interior;           /**< Rows needing no ghost entry */
+    int interior_count;      /**< Number of interior rows */
+    int *boundary;           /**< Rows needing ghost entries */
+    int boundary_count;      /**< Number of boundary rows */
+    int recv_neighbours;     /**< Processes ghost entries come from */
+    int *recv_ranks;         /**< Rank of every process sending ghost entries */
+    int *recv_counts;        /**< Ghost entries from every process */
+    int *recv_displs;        /**< First ghost entry from every process */
+    int send_neighbours;     /**< Processes owned entries go to */
+    int *send_ranks;         /**< Rank of every process receiving owned entries */
+    int *send_counts;        /**< Owned entries to every process */
+    int *send_displs;        /**< First owned entry to every process */
+    int *send_index;         /**< Local row of every owned entry to send */
+    double *send_buffer;     /**< Packed owned entries to send */
+    MPI_Request *requests;   /**< Requests of an exchange */
+    int max_iterations;      /**< Iterations allowed before giving up */
+    int num_iterations;      /**< Iterations of last solution */
+    double diffnorm;         /**< Error of last solution */
+    struct phases *phases;   /**< Phase accumulators */
+};
+
+int sparse_create(struct sparse *, MPI_Comm, struct csr *, struct phases *);
+void sparse_scatter(struct sparse *, double *);
+void sparse_iterate(struct sparse *);
+void sparse_gather(struct sparse *, double *);
+void sparse_free(struct sparse *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPARSE_H_
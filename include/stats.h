@@ -0,0 +1,43 @@
+/**
+ * @file stats.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for timing statistics functions.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef STATS_H_
+#define STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Summary of repeated time measurements.
+ *
+ * Summary of repeated time measurements.
+ */
+struct time_stats {
+    double median; /**< Median time */
+    double min;    /**< Minimum time */
+    double max;    /**< Maximum time */
+    double p05;    /**< 5th percentile */
+    double p95;    /**< 95th percentile */
+    int samples;   /**< Number of samples */
+};
+
+void sort_doubles(double *, int);
+double percentile(double *, int, double);
+void summarize_times(double *, int, struct time_stats *);
+int times_stable(double *, int, int, double);
+double peak_memory(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STATS_H_
@@ -0,0 +1,60 @@
+/**
+ * @file trace.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for per-rank timelines in Chrome trace format.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Events kept by every rank, latest ones win.
+ */
+static const int TRACE_EVENTS = 1 << 16;
+/**
+ * @brief Round trips to MASTER measuring clock offset of a rank.
+ */
+static const int TRACE_SYNC_ROUNDS = 16;
+
+/**
+ * @brief A timestamped phase of a rank.
+ */
+struct trace_event {
+    double begin; /**< Local time phase began at */
+    double end;   /**< Local time phase ended at */
+    int phase;    /**< Phase */
+};
+
+/**
+ * @brief Timeline of a rank.
+ *
+ * Timeline of a rank, as a ring buffer allocated once, so that
+ * recording an event never allocates nor writes anything out.
+ */
+struct trace {
+    struct trace_event *events; /**< Ring buffer of events */
+    int capacity;               /**< Events the ring buffer holds */
+    long recorded;              /**< Events recorded so far, overwritten ones included */
+};
+
+void trace_create(struct trace *, int);
+void trace_record(struct trace *, int, double, double);
+int trace_write(struct trace *, const char *, MPI_Comm);
+void trace_free(struct trace *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H_
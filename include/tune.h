@@ -0,0 +1,49 @@
+/**
+ * @file tune.h
+ * @ingroup headers
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Header file for autotuning of communication parameters.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#ifndef TUNE_H_
+#define TUNE_H_
+
+#include "mpi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default tuning cache file.
+ */
+static const char TUNE_FILE[] = "jacobi-tune.csv";
+/**
+ * @brief Iterations of a trial solution.
+ */
+static const int TUNE_ITERATIONS = 10;
+
+/**
+ * @brief A configuration of tunable parameters.
+ *
+ * A configuration of tunable parameters, along with its trial time.
+ */
+struct tuning {
+    int backend;  /**< Ghost rows exchange backend */
+    int compress; /**< Ghost rows compression mode */
+    double time;  /**< Median trial time */
+};
+
+int tune_lookup(const char *, char *, int, int, struct tuning *);
+int tune_record(const char *, char *, int, int, struct tuning *);
+void tune_search(MPI_Comm, int, double *, struct tuning *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TUNE_H_
@@ -0,0 +1,183 @@
+/**
+ * @file active.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Active-set Jacobi method skipping settled tiles.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "active.h"
+#include "jacobi.h"
+
+/**
+ * @brief Bounds of a tile, in inner cells.
+ *
+ * @param tile Tile index
+ * @param tile_columns Tiles along a row
+ * @param rows Number of matrix rows
+ * @param columns Number of matrix columns
+ * @param bounds First row, row past last one, first column and
+ * column past last one
+ */
+static void tile_bounds(int tile, int tile_columns, int rows, int columns, int bounds[4]) {
+    bounds[0] = 1 + tile / tile_columns * ACTIVE_TILE;
+    bounds[1] = (bounds[0] + ACTIVE_TILE < rows - 1)? bounds[0] + ACTIVE_TILE: rows - 1;
+    bounds[2] = 1 + tile % tile_columns * ACTIVE_TILE;
+    bounds[3] = (bounds[2] + ACTIVE_TILE < columns - 1)? bounds[2] + ACTIVE_TILE: columns - 1;
+}
+
+/**
+ * @brief Update the cells of a tile, as `jacobi_iteration` does.
+ *
+ * @param A Input matrix
+ * @param A_prime The 'A' matrix after Jacobi iteration
+ * @param columns Number of matrix columns
+ * @param bounds Tile bounds
+ * @return double Sum of squared updates of the tile
+ */
+static double tile_sweep(double *A, double *A_prime, int columns, int bounds[4]) {
+    double diff = 0.0;
+
+    for (int i = bounds[0]; i < bounds[1]; i++) {
+        size_t row = (size_t) i * columns;
+
+        for (int j = bounds[2]; j < bounds[3]; j++) {
+            A_prime[row + j] = (
+                A[row + columns + j] +
+                A[row - columns + j] +
+                A[row + j+1] +
+                A[row + j-1]
+            )/4.0;
+            diff += (A_prime[row + j] - A[row + j]) *
+                (A_prime[row + j] - A[row + j]);
+        }
+    }
+
+    return diff;
+}
+
+/**
+ * @brief Jacobi method sweeping only tiles that still change.
+ *
+ * Inner cells are split into tiles of `ACTIVE_TILE` rows and columns. A
+ * tile whose update falls below `ACTIVE_FRACTION` of
+ * `CONVERGENCE_THRESHOLD` is frozen: its cells keep their values, and it
+ * is swept again every `ACTIVE_RECHECK` iterations, or as soon as a
+ * tile next to it changes by more than that, and then thawed if needed.
+ * The residual is the one of swept tiles plus the last one measured for
+ * every frozen tile, so that frozen tiles never count as settled
+ * further than they were seen to be.
+ *
+ * @param A Input matrix, solution on return
+ * @param rows Number of matrix rows
+ * @param columns Number of matrix columns
+ * @param eps Residual of last iteration
+ * @param stats Figures of the solution
+ * @return int Number of iterations
+ */
+int jacobi_active(double *A, int rows, int columns, double *eps, struct active_stats *stats) {
+    int tile_rows = (rows - 2 + ACTIVE_TILE - 1) / ACTIVE_TILE;
+    int tile_columns = (columns - 2 + ACTIVE_TILE - 1) / ACTIVE_TILE;
+    int tiles = tile_rows * tile_columns;
+    double bound = ACTIVE_FRACTION * CONVERGENCE_THRESHOLD;
+    double *A_prime = malloc((size_t) rows * columns * sizeof *A_prime);
+    double *change = calloc(tiles, sizeof *change);
+    int *frozen_at = malloc(tiles * sizeof *frozen_at);
+    unsigned char *sweep = malloc(tiles);
+    int bounds[4];
+    double cells;
+    double diff;
+    int itr = 0;
+
+    // squared updates are compared against squared bound
+    bound *= bound;
+    memcpy(A_prime, A, (size_t) rows * columns * sizeof *A_prime);
+    for (int t = 0; t < tiles; t++) {
+        frozen_at[t] = -1;
+    }
+    stats->updated = 0.0;
+    stats->skipped = 0.0;
+    stats->tiles = tiles;
+    stats->woken = 0;
+
+    do {
+        itr++;
+
+        // active tiles, frozen ones due for a recheck and
+        // frozen ones next to a changing tile get swept
+        for (int t = 0; t < tiles; t++) {
+            int r = t / tile_columns;
+            int c = t % tile_columns;
+            int neighbours[4] = {
+                (r > 0)? t - tile_columns: -1,
+                (r < tile_rows - 1)? t + tile_columns: -1,
+                (c > 0)? t - 1: -1,
+                (c < tile_columns - 1)? t + 1: -1
+            };
+
+            sweep[t] = frozen_at[t] < 0 || (itr - frozen_at[t]) % ACTIVE_RECHECK == 0;
+            for (int k = 0; k < 4 && !sweep[t]; k++) {
+                if (neighbours[k] >= 0 && frozen_at[neighbours[k]] < 0 &&
+                    change[neighbours[k]] >= bound) {
+                    sweep[t] = 1;
+                    stats->woken++;
+                }
+            }
+        }
+
+        // every swept tile reads values of previous iteration
+        for (int t = 0; t < tiles; t++) {
+            tile_bounds(t, tile_columns, rows, columns, bounds);
+            cells = (bounds[1] - bounds[0]) * (double) (bounds[3] - bounds[2]);
+            if (sweep[t]) {
+                change[t] = tile_sweep(A, A_prime, columns, bounds);
+                stats->updated += cells;
+            } else {
+                stats->skipped += cells;
+            }
+        }
+
+        // copy swept tiles back, frozen ones are the same in both
+        // matrices, and sum residual with stale figures of frozen tiles
+        diff = 0.0;
+        for (int t = 0; t < tiles; t++) {
+            if (sweep[t]) {
+                tile_bounds(t, tile_columns, rows, columns, bounds);
+                for (int i = bounds[0]; i < bounds[1]; i++) {
+                    size_t row = (size_t) i * columns;
+
+                    memcpy(
+                        &A[row + bounds[2]], &A_prime[row + bounds[2]],
+                        (bounds[3] - bounds[2]) * sizeof *A
+                    );
+                }
+                if (change[t] >= bound) {
+                    frozen_at[t] = -1;
+                } else if (frozen_at[t] < 0) {
+                    frozen_at[t] = itr;
+                }
+            }
+            diff += change[t];
+        }
+        diff = sqrt(diff);
+    } while (diff > CONVERGENCE_THRESHOLD && itr < MAX_ITERATIONS);
+
+    stats->frozen = 0;
+    for (int t = 0; t < tiles; t++) {
+        stats->frozen += frozen_at[t] >= 0;
+    }
+    free(A_prime);
+    free(change);
+    free(frozen_at);
+    free(sweep);
+    *eps = diff;
+
+    return itr;
+}
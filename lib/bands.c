@@ -0,0 +1,333 @@
+/**
+ * @file bands.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Multithreaded Jacobi method over row bands.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _XOPEN_SOURCE 700 /**< Use clock_gettime and sched_yield definitions from POSIX */
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bands.h"
+#include "jacobi.h"
+
+/**
+ * @brief Grid copies rotated among iterations.
+ *
+ * With three copies, the grid after an iteration survives the two
+ * iterations after it, so that threads go on while its residual is
+ * being reduced.
+ */
+#define BUFFERS 3
+
+/**
+ * @brief Iterations whose residuals may be in reduction at once.
+ */
+#define SLOTS 4
+
+/**
+ * @brief Failed checks before a waiting thread yields its CPU.
+ */
+static const int SPINS = 64;
+
+/**
+ * @brief Iteration counter alone in its cache line.
+ */
+struct counter {
+    int value;                     /**< Last completed iteration */
+    char pad[64 - sizeof (int)];   /**< Padding to cache line */
+};
+
+/**
+ * @brief State shared by threads of a solution.
+ */
+struct shared {
+    double *buffer[BUFFERS]; /**< Grid copies, first one is input matrix */
+    int n;                   /**< Matrix order */
+    int threads;             /**< Number of threads */
+    struct counter *done;    /**< Counter of every band, plus one at both ends */
+    int leaves;              /**< Leaves of reduction tree, a power of two */
+    int *weight;             /**< Bands under every tree node */
+    double *value;           /**< Partial residual of every tree node, by slot */
+    int *arrived;            /**< Children arrived at every tree node, by slot */
+    int reduced;             /**< Last iteration whose residual is known */
+    int stop_at;             /**< Iteration to stop at, as known so far */
+    double residual;         /**< Residual of iteration to stop at */
+};
+
+/**
+ * @brief A band of rows and the thread owning it.
+ */
+struct band {
+    struct shared *shared; /**< State shared by threads */
+    int t;                 /**< Band index */
+    int first_row;         /**< First owned row */
+    int last_row;          /**< Row after last owned one */
+    int iterations;        /**< Iterations run */
+    double wait_seconds;   /**< Time spent waiting */
+};
+
+/**
+ * @brief Seconds elapsed on monotonic clock.
+ *
+ * @return double Seconds
+ */
+static double now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec * 1E-9;
+}
+
+/**
+ * @brief Add the residual of a band to the reduction of an iteration.
+ *
+ * Every tree node is combined by the last of its children to arrive,
+ * which goes on climbing; others leave at once. Children are summed
+ * left to right whatever their arrival order, so the residual is the
+ * same in every run. The thread completing the root publishes it.
+ *
+ * @param s Shared state
+ * @param t Band index
+ * @param iteration Iteration, from 1
+ * @param partial Squared norm of the update of the band
+ */
+static void reduce(struct shared *s, int t, int iteration, double partial) {
+    int nodes = 2 * s->leaves;
+    double *value = &s->value[(iteration % SLOTS) * nodes];
+    int *arrived = &s->arrived[(iteration % SLOTS) * nodes];
+    int expected;
+    int stop_at;
+    double sum;
+    int i = s->leaves + t;
+
+    value[i] = partial;
+    for (i /= 2; i >= 1; i /= 2) {
+        expected = (s->weight[2 * i] > 0) + (s->weight[2 * i + 1] > 0);
+        if (__atomic_add_fetch(&arrived[i], 1, __ATOMIC_ACQ_REL) < expected) {
+            return;
+        }
+        // slot is reused four iterations later, after this one is known
+        __atomic_store_n(&arrived[i], 0, __ATOMIC_RELAXED);
+        sum = 0.0;
+        if (s->weight[2 * i] > 0) {
+            sum += value[2 * i];
+        }
+        if (s->weight[2 * i + 1] > 0) {
+            sum += value[2 * i + 1];
+        }
+        value[i] = sum;
+    }
+
+    // iterations get reduced in order, the first converged one stops
+    sum = sqrt(value[1]);
+    stop_at = __atomic_load_n(&s->stop_at, __ATOMIC_RELAXED);
+    if ((sum <= CONVERGENCE_THRESHOLD && iteration < stop_at) || iteration == stop_at) {
+        s->residual = sum;
+        __atomic_store_n(&s->stop_at, iteration, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&s->reduced, iteration, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Wait until a band may run an iteration.
+ *
+ * Neighbour bands must have completed previous iteration, since this
+ * one reads their rows and overwrites the grid copy they read, and the
+ * residual of the iteration three back must be known, since this one
+ * overwrites its grid copy. The iteration to stop at is published
+ * before the residual that sets it, so it is checked again once the
+ * residual is seen, or a band could overwrite the converged grid.
+ *
+ * @param b Band
+ * @param iteration Iteration, from 1
+ * @return int 1 if the band may run the iteration, 0 if solution stops before it
+ */
+static int wait_turn(struct band *b, int iteration) {
+    struct shared *s = b->shared;
+    double start = 0.0;
+    int spins = 0;
+    int go;
+
+    while (1) {
+        if (__atomic_load_n(&s->stop_at, __ATOMIC_ACQUIRE) < iteration) {
+            go = 0;
+            break;
+        }
+        if (__atomic_load_n(&s->reduced, __ATOMIC_ACQUIRE) >= iteration - BUFFERS &&
+            __atomic_load_n(&s->done[b->t].value, __ATOMIC_ACQUIRE) >= iteration - 1 &&
+            __atomic_load_n(&s->done[b->t + 2].value, __ATOMIC_ACQUIRE) >= iteration - 1) {
+            go = __atomic_load_n(&s->stop_at, __ATOMIC_ACQUIRE) >= iteration;
+            break;
+        }
+        if (spins++ == 0) {
+            start = now();
+        } else if (spins % SPINS == 0) {
+            sched_yield();
+        }
+    }
+    if (spins > 0) {
+        b->wait_seconds += now() - start;
+    }
+
+    return go;
+}
+
+/**
+ * @brief Body of a band thread.
+ *
+ * Grid copies of the band are initialized by its own thread, so that
+ * their pages are local to it.
+ *
+ * @param arg Band
+ * @return void* Always NULL
+ */
+static void *band_run(void *arg) {
+    struct band *b = arg;
+    struct shared *s = b->shared;
+    int n = s->n;
+    int first = (b->t == 0)? 0: b->first_row;
+    int last = (b->t == s->threads - 1)? n: b->last_row;
+    int rows = b->last_row - b->first_row;
+    size_t offset = (size_t) (b->first_row - 1) * n;
+    double partial;
+
+    for (int c = 1; c < BUFFERS; c++) {
+        memcpy(
+            &s->buffer[c][(size_t) first * n], &s->buffer[0][(size_t) first * n],
+            (size_t) (last - first) * n * sizeof **s->buffer
+        );
+    }
+
+    for (int j = 1; wait_turn(b, j); j++) {
+        double *src = s->buffer[(j - 1) % BUFFERS];
+        double *dst = s->buffer[j % BUFFERS];
+
+        jacobi_iteration(&src[offset], &dst[offset], rows + 2, n);
+        partial = convergence_check_g(&src[offset], &dst[offset], rows + 2, n);
+        __atomic_store_n(&s->done[b->t + 1].value, j, __ATOMIC_RELEASE);
+        reduce(s, b->t, j, partial);
+        b->iterations = j;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Multithreaded Jacobi method.
+ *
+ * Inner rows are split in bands, one per thread. Threads synchronize
+ * only with neighbour bands, through their iteration counters, and
+ * combine residuals through a lock-free tree; threads run up to two
+ * iterations ahead of the last known residual, and those past
+ * convergence are thrown away. Result and iterations are the same as
+ * `jacobi`.
+ *
+ * @param A Input matrix, overwritten by solution
+ * @param n Matrix order
+ * @param threads Number of threads, no more than inner rows are used
+ * @param eps Error in applicating Jacobi method
+ * @param stats Figures of the solution
+ * @return int Number of Jacobi method iterations, -1 on error
+ */
+int bands_jacobi(double *A, int n, int threads, double *eps, struct bands_stats *stats) {
+    struct shared s;
+    struct band *bands;
+    pthread_t *workers;
+    int *started;
+    int status = 0;
+
+    if (threads > n - 2) {
+        threads = n - 2;
+    }
+    if (threads < 1) {
+        return -1;
+    }
+
+    memset(&s, 0, sizeof s);
+    s.n = n;
+    s.threads = threads;
+    s.buffer[0] = A;
+    s.buffer[1] = malloc((size_t) n * n * sizeof *A);
+    s.buffer[2] = malloc((size_t) n * n * sizeof *A);
+    s.done = calloc(threads + 2, sizeof *s.done);
+    // ends have no neighbour to wait for
+    s.done[0].value = s.done[threads + 1].value = MAX_ITERATIONS;
+    s.leaves = 1;
+    while (s.leaves < threads) {
+        s.leaves *= 2;
+    }
+    s.weight = calloc(2 * s.leaves, sizeof *s.weight);
+    for (int i = 2 * s.leaves - 1; i >= 1; i--) {
+        s.weight[i] = (i >= s.leaves)?
+            (i - s.leaves < threads):
+            s.weight[2 * i] + s.weight[2 * i + 1];
+    }
+    s.value = malloc(SLOTS * 2 * s.leaves * sizeof *s.value);
+    s.arrived = calloc(SLOTS * 2 * s.leaves, sizeof *s.arrived);
+    s.stop_at = MAX_ITERATIONS;
+    bands = malloc(threads * sizeof *bands);
+    workers = malloc(threads * sizeof *workers);
+    started = malloc(threads * sizeof *started);
+
+    for (int t = 0; t < threads; t++) {
+        bands[t].shared = &s;
+        bands[t].t = t;
+        bands[t].first_row = 1 + (int) ((long) (n - 2) * t / threads);
+        bands[t].last_row = 1 + (int) ((long) (n - 2) * (t + 1) / threads);
+        bands[t].iterations = 0;
+        bands[t].wait_seconds = 0.0;
+    }
+    // every band waits for its neighbours, so all of them have to run
+    for (int t = 0; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, band_run, &bands[t]) == 0;
+        status |= !started[t];
+    }
+    if (status) {
+        // let started threads through, then give up
+        __atomic_store_n(&s.stop_at, 0, __ATOMIC_RELEASE);
+    }
+    for (int t = 0; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+
+    stats->threads = threads;
+    stats->wasted = 0;
+    stats->wait_seconds = 0.0;
+    for (int t = 0; t < threads; t++) {
+        if (bands[t].iterations - s.stop_at > stats->wasted) {
+            stats->wasted = bands[t].iterations - s.stop_at;
+        }
+        if (bands[t].wait_seconds > stats->wait_seconds) {
+            stats->wait_seconds = bands[t].wait_seconds;
+        }
+    }
+    if (!status && s.stop_at % BUFFERS != 0) {
+        memcpy(A, s.buffer[s.stop_at % BUFFERS], (size_t) n * n * sizeof *A);
+    }
+    *eps = s.residual;
+
+    free(s.buffer[1]);
+    free(s.buffer[2]);
+    free(s.done);
+    free(s.weight);
+    free(s.value);
+    free(s.arrived);
+    free(bands);
+    free(workers);
+    free(started);
+
+    return status? -1: s.stop_at;
+}
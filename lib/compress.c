@@ -0,0 +1,258 @@
+/**
+ * @file compress.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Ghost row compression.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compress.h"
+#include "jacobi.h"
+
+/**
+ * @brief Mode names as given on command line.
+ *
+ * Mode names as given on command line.
+ */
+const char *COMPRESS_NAMES[COMPRESS_COUNT] = {
+    "none",
+    "lossless",
+    "lossy"
+};
+
+/**
+ * @brief Longest run of an RLE token.
+ */
+static const int RUN_LENGTH = 128;
+
+/**
+ * @brief RLE token flag for a run of zero bytes.
+ */
+static const unsigned char ZERO_RUN = 0x80;
+
+/**
+ * @brief Get compression mode from its name.
+ *
+ * @param name Mode name, NULL for no compression
+ * @return int Mode, -1 if unknown
+ */
+int compress_parse(char *name) {
+    if (name == NULL) {
+        return COMPRESS_NONE;
+    }
+    for (int m = 0; m < COMPRESS_COUNT; m++) {
+        if (strcmp(name, COMPRESS_NAMES[m]) == 0) {
+            return m;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Set up a codec for rows of given length.
+ *
+ * Lossy mode quantizes every element to a step such that the error
+ * over the whole row stays within half the convergence threshold.
+ *
+ * @param c Codec
+ * @param mode Compression mode
+ * @param n Row length
+ */
+void compress_create(struct compress *c, enum compress_mode mode, int n) {
+    c->mode = mode;
+    c->n = n;
+    c->quantum = CONVERGENCE_THRESHOLD / sqrt(n);
+    c->words = malloc(n * sizeof *c->words);
+    c->planes = malloc(n * sizeof *c->words);
+}
+
+/**
+ * @brief Largest compressed size of a row.
+ *
+ * @param n Row length
+ * @return size_t Bytes, RLE tokens included
+ */
+size_t compress_bound(int n) {
+    size_t bytes = n * sizeof (uint64_t);
+
+    // a token every literal run, plus a trailing zero
+    return bytes + (bytes + RUN_LENGTH - 1) / RUN_LENGTH + 1;
+}
+
+/**
+ * @brief Encode bytes as runs of zeros and literal runs.
+ *
+ * Every token is a byte: with `ZERO_RUN` flag, the lower bits give
+ * a run of zeros, otherwise a number of literal bytes that follow.
+ *
+ * @param in Bytes to encode
+ * @param bytes Number of bytes
+ * @param out Encoded bytes, at least `compress_bound` long
+ * @return size_t Encoded size
+ */
+static size_t rle_encode(unsigned char *in, size_t bytes, unsigned char *out) {
+    size_t i = 0;
+    size_t o = 0;
+    size_t run;
+
+    while (i < bytes) {
+        run = 0;
+        if (in[i] == 0) {
+            while (i + run < bytes && run < (size_t) RUN_LENGTH && in[i + run] == 0) {
+                run++;
+            }
+            out[o++] = ZERO_RUN | (run - 1);
+        } else {
+            // a single zero is cheaper as a literal
+            while (i + run < bytes && run < (size_t) RUN_LENGTH &&
+                   (in[i + run] != 0 ||
+                    (i + run + 1 < bytes && in[i + run + 1] != 0))) {
+                run++;
+            }
+            out[o++] = run - 1;
+            memcpy(&out[o], &in[i], run);
+            o += run;
+        }
+        i += run;
+    }
+
+    return o;
+}
+
+/**
+ * @brief Decode runs of zeros and literal runs.
+ *
+ * @param in Encoded bytes
+ * @param bytes Number of encoded bytes
+ * @param out Decoded bytes
+ * @param expected Number of decoded bytes
+ * @return int 0 on success, -1 if encoded bytes are malformed
+ */
+static int rle_decode(unsigned char *in, size_t bytes, unsigned char *out, size_t expected) {
+    size_t i = 0;
+    size_t o = 0;
+    size_t run;
+
+    while (i < bytes) {
+        run = (in[i] & ~ZERO_RUN) + 1;
+        if (o + run > expected) {
+            return -1;
+        }
+        if (in[i++] & ZERO_RUN) {
+            memset(&out[o], 0, run);
+        } else {
+            if (i + run > bytes) {
+                return -1;
+            }
+            memcpy(&out[o], &in[i], run);
+            i += run;
+        }
+        o += run;
+    }
+
+    return (o == expected)? 0: -1;
+}
+
+/**
+ * @brief Compress a row against a reference row.
+ *
+ * Lossless mode XORs the bits of every element with the reference;
+ * lossy mode takes the quantized difference, zigzag encoded, so that
+ * the reference tracks what the receiver reconstructs and errors do not
+ * pile up. Either way, slowly changing rows give words whose high bytes
+ * are zero: words are split into byte planes so that those zeros get
+ * contiguous, then run-length encoded.
+ *
+ * @param c Codec
+ * @param row Row to compress
+ * @param ref Reference row, updated
+ * @param out Compressed row, at least `compress_bound` long
+ * @return size_t Compressed size
+ */
+size_t compress_row(struct compress *c, double *row, double *ref, unsigned char *out) {
+    int n = c->n;
+    uint64_t bits;
+    uint64_t ref_bits;
+    int64_t k;
+
+    for (int j = 0; j < n; j++) {
+        if (c->mode == COMPRESS_LOSSY) {
+            k = llround((row[j] - ref[j]) / c->quantum);
+            ref[j] += k * c->quantum;
+            c->words[j] = ((uint64_t) k << 1) ^ (uint64_t) (k >> 63);
+        } else {
+            memcpy(&bits, &row[j], sizeof bits);
+            memcpy(&ref_bits, &ref[j], sizeof ref_bits);
+            c->words[j] = bits ^ ref_bits;
+            ref[j] = row[j];
+        }
+    }
+    for (int b = 0; b < (int) sizeof *c->words; b++) {
+        for (int j = 0; j < n; j++) {
+            c->planes[b * n + j] = c->words[j] >> (8 * b);
+        }
+    }
+
+    return rle_encode(c->planes, n * sizeof *c->words, out);
+}
+
+/**
+ * @brief Expand a compressed row against a reference row.
+ *
+ * @param c Codec
+ * @param in Compressed row
+ * @param bytes Compressed size
+ * @param row Expanded row
+ * @param ref Reference row, updated
+ * @return int 0 on success, -1 if compressed row is malformed
+ */
+int expand_row(struct compress *c, unsigned char *in, size_t bytes, double *row, double *ref) {
+    int n = c->n;
+    uint64_t bits;
+    int64_t k;
+
+    if (rle_decode(in, bytes, c->planes, n * sizeof *c->words) != 0) {
+        return -1;
+    }
+    for (int j = 0; j < n; j++) {
+        c->words[j] = 0;
+    }
+    for (int b = 0; b < (int) sizeof *c->words; b++) {
+        for (int j = 0; j < n; j++) {
+            c->words[j] |= (uint64_t) c->planes[b * n + j] << (8 * b);
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        if (c->mode == COMPRESS_LOSSY) {
+            k = (int64_t) (c->words[j] >> 1) ^ -(int64_t) (c->words[j] & 1);
+            ref[j] += k * c->quantum;
+        } else {
+            memcpy(&bits, &ref[j], sizeof bits);
+            bits ^= c->words[j];
+            memcpy(&ref[j], &bits, sizeof bits);
+        }
+        row[j] = ref[j];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Free memory held by a codec.
+ *
+ * @param c Codec
+ */
+void compress_free(struct compress *c) {
+    free(c->words);
+    free(c->planes);
+    c->words = NULL;
+    c->planes = NULL;
+}
@@ -0,0 +1,393 @@
+/**
+ * @file csr.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Jacobi method over sparse matrices in CSR format.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+#include "csr.h"
+#include "jacobi.h"
+#include "matrixutils.h"
+
+/**
+ * @brief Allocate a matrix with given number of entries.
+ *
+ * @param A Matrix
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param nnz Number of entries
+ */
+static void csr_alloc(struct csr *A, int rows, int cols, size_t nnz) {
+    A->rows = rows;
+    A->cols = cols;
+    A->nnz = nnz;
+    A->row_ptr = calloc(rows + 1, sizeof *A->row_ptr);
+    A->col = malloc(nnz * sizeof *A->col);
+    A->val = malloc(nnz * sizeof *A->val);
+}
+
+/**
+ * @brief Sort entries of every row by column, summing duplicates.
+ *
+ * Rows are short, so insertion sort does. Number of nonzeros shrinks
+ * by the duplicates, arrays are left as allocated.
+ *
+ * @param A Matrix
+ */
+static void csr_sort(struct csr *A) {
+    size_t out = 0;
+    size_t start;
+    int c;
+    double v;
+
+    for (int i = 0; i < A->rows; i++) {
+        start = out;
+        for (size_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            c = A->col[k];
+            v = A->val[k];
+            size_t p = out;
+            while (p > start && A->col[p - 1] > c) {
+                A->col[p] = A->col[p - 1];
+                A->val[p] = A->val[p - 1];
+                p--;
+            }
+            if (p > start && A->col[p - 1] == c) {
+                // undo the shift, then sum
+                for (size_t q = p; q < out; q++) {
+                    A->col[q] = A->col[q + 1];
+                    A->val[q] = A->val[q + 1];
+                }
+                A->val[p - 1] += v;
+            } else {
+                A->col[p] = c;
+                A->val[p] = v;
+                out++;
+            }
+        }
+        A->row_ptr[i] = start;
+    }
+    A->row_ptr[A->rows] = out;
+    A->nnz = out;
+}
+
+/**
+ * @brief Generate a sparse dominant diagonal matrix.
+ *
+ * Every row gets `SPARSE_NEIGHBOURS` off-diagonal entries at random
+ * columns within about square root of order from the diagonal, as rows
+ * of a mesh numbered by a bandwidth-reducing ordering do; every diagonal
+ * element is twice the sum of other magnitudes in its row, plus the
+ * upper bound, as in `generate_dd_matrix_array`.
+ *
+ * @param A Matrix
+ * @param n Matrix order
+ * @param min Minimum generated value
+ * @param max Maximum generated value
+ * @param seed Seed for rand() function
+ */
+void csr_generate(struct csr *A, int n, double min, double max, int seed) {
+    int width = (int) sqrt(n) + 1;
+    size_t k = 0;
+    size_t diagonal;
+    int j;
+    double sum;
+
+    csr_alloc(A, n, n, (size_t) n * (SPARSE_NEIGHBOURS + 1));
+    srand(seed);
+    for (int i = 0; i < n; i++) {
+        A->row_ptr[i] = k;
+        diagonal = k;
+        A->col[k] = i;
+        A->val[k++] = 0.0;
+        for (int e = 0; e < SPARSE_NEIGHBOURS; e++) {
+            j = i - width + rand() % (2 * width + 1);
+            if (j < 0 || j >= n || j == i) {
+                continue;
+            }
+            A->col[k] = j;
+            A->val[k++] = min + (rand() / (RAND_MAX / (max - min)));
+        }
+        A->row_ptr[i + 1] = k;
+
+        sum = 0.0;
+        for (size_t e = diagonal + 1; e < k; e++) {
+            sum += fabs(A->val[e]);
+        }
+        A->val[diagonal] = 2.0 * sum + max;
+    }
+    csr_sort(A);
+}
+
+/**
+ * @brief Read a matrix from a MatrixMarket coordinate file.
+ *
+ * Real, integer and pattern (all ones) fields are read, along with
+ * general, symmetric and skew-symmetric storage; only square matrices
+ * are accepted.
+ *
+ * @param A Matrix
+ * @param file MatrixMarket file name
+ * @return int 0 on success, -1 on error
+ */
+int csr_read(struct csr *A, const char *file) {
+    FILE *mm = fopen(file, "r");
+    char line[1024];
+    char object[32], format[32], field[32], symmetry[32];
+    int rows, cols;
+    size_t entries;
+    int symmetric, skew, pattern;
+    int *row_of;
+    int *col_of;
+    double *val_of;
+    size_t count = 0;
+    int i, j;
+    double v;
+
+    if (mm == NULL) {
+        fprintf(stderr, "Cannot open matrix file %s\n", file);
+        return -1;
+    }
+    if (fgets(line, sizeof line, mm) == NULL ||
+        sscanf(line, "%%%%MatrixMarket %31s %31s %31s %31s", object, format, field, symmetry) != 4 ||
+        strcasecmp(object, "matrix") != 0 || strcasecmp(format, "coordinate") != 0 ||
+        strcasecmp(field, "complex") == 0) {
+        fprintf(stderr, "%s is not a real MatrixMarket coordinate matrix\n", file);
+        fclose(mm);
+        return -1;
+    }
+    symmetric = strcasecmp(symmetry, "general") != 0;
+    skew = strcasecmp(symmetry, "skew-symmetric") == 0;
+    pattern = strcasecmp(field, "pattern") == 0;
+
+    // skip comments up to size line
+    do {
+        if (fgets(line, sizeof line, mm) == NULL) {
+            fclose(mm);
+            return -1;
+        }
+    } while (line[0] == '%');
+    if (sscanf(line, "%d %d %zu", &rows, &cols, &entries) != 3 ||
+        rows != cols || rows <= 0) {
+        fprintf(stderr, "%s is not a square matrix\n", file);
+        fclose(mm);
+        return -1;
+    }
+
+    // coordinates first, mirrored entries of symmetric storage included
+    row_of = malloc(2 * entries * sizeof *row_of);
+    col_of = malloc(2 * entries * sizeof *col_of);
+    val_of = malloc(2 * entries * sizeof *val_of);
+    for (size_t e = 0; e < entries; e++) {
+        v = 1.0;
+        if (fscanf(mm, "%d %d", &i, &j) != 2 ||
+            (!pattern && fscanf(mm, "%lf", &v) != 1) ||
+            i < 1 || i > rows || j < 1 || j > cols) {
+            fprintf(stderr, "Malformed entry %zu in %s\n", e + 1, file);
+            free(row_of);
+            free(col_of);
+            free(val_of);
+            fclose(mm);
+            return -1;
+        }
+        row_of[count] = i - 1;
+        col_of[count] = j - 1;
+        val_of[count++] = v;
+        if (symmetric && i != j) {
+            row_of[count] = j - 1;
+            col_of[count] = i - 1;
+            val_of[count++] = skew? -v: v;
+        }
+    }
+    fclose(mm);
+
+    // then rows, by counting sort
+    csr_alloc(A, rows, cols, count);
+    for (size_t e = 0; e < count; e++) {
+        A->row_ptr[row_of[e] + 1]++;
+    }
+    for (int r = 0; r < rows; r++) {
+        A->row_ptr[r + 1] += A->row_ptr[r];
+    }
+    for (size_t e = 0; e < count; e++) {
+        size_t k = A->row_ptr[row_of[e]]++;
+
+        A->col[k] = col_of[e];
+        A->val[k] = val_of[e];
+    }
+    for (int r = rows; r > 0; r--) {
+        A->row_ptr[r] = A->row_ptr[r - 1];
+    }
+    A->row_ptr[0] = 0;
+    csr_sort(A);
+
+    free(row_of);
+    free(col_of);
+    free(val_of);
+
+    return 0;
+}
+
+/**
+ * @brief Sparse matrix-vector product.
+ *
+ * @param A Matrix
+ * @param x Vector, `cols` long
+ * @param y Product, `rows` long
+ */
+void csr_product(struct csr *A, double *x, double *y) {
+    double sum;
+
+    for (int i = 0; i < A->rows; i++) {
+        sum = 0.0;
+        for (size_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            sum += A->val[k] * x[A->col[k]];
+        }
+        y[i] = sum;
+    }
+}
+
+/**
+ * @brief Generate known terms as product of matrix and a random solution.
+ *
+ * @param A Matrix
+ * @param b Known terms
+ * @param min Minimum generated value
+ * @param max Maximum generated value
+ * @param seed Seed for rand() function
+ */
+void csr_system(struct csr *A, double *b, double min, double max, int seed) {
+    double *x = malloc(A->cols * sizeof *x);
+
+    generate_matrix_array(x, 1, A->cols, min, max, seed);
+    csr_product(A, x, b);
+    free(x);
+}
+
+/**
+ * @brief Inverse of the diagonal of a matrix.
+ *
+ * Diagonal element of row i is the one in column i, so columns of
+ * distributed rows have to be numbered with owned rows first.
+ *
+ * @param A Matrix
+ * @param inv_diag Inverse diagonal elements
+ * @return int 0 on success, -1 if a diagonal element is missing or zero
+ */
+int csr_inverse_diagonal(struct csr *A, double *inv_diag) {
+    int status = 0;
+
+    for (int i = 0; i < A->rows; i++) {
+        inv_diag[i] = 0.0;
+        for (size_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            if (A->col[k] == i && A->val[k] != 0.0) {
+                inv_diag[i] = 1.0 / A->val[k];
+            }
+        }
+        status |= (inv_diag[i] == 0.0)? -1: 0;
+    }
+
+    return status;
+}
+
+/**
+ * @brief A single Jacobi iteration over some rows of Ax=b.
+ *
+ * Updates are computed as x_i + (b_i - a_i x) / a_ii, as in
+ * `dense_sweep`, each row summing its entries in stored order.
+ *
+ * @param A Matrix
+ * @param b Known terms
+ * @param inv_diag Inverse diagonal elements
+ * @param x Solution before iteration, indexed by column
+ * @param x_new Solution after iteration, indexed by row
+ * @param rows Rows to update, NULL for the first `count` ones
+ * @param count Number of rows to update
+ * @return double Squared norm of the update of given rows
+ */
+double csr_sweep(
+    struct csr *A,
+    double *b,
+    double *inv_diag,
+    double *x,
+    double *x_new,
+    int *rows,
+    int count
+) {
+    double diff = 0.0;
+    double sum;
+    int i;
+
+    for (int r = 0; r < count; r++) {
+        i = (rows != NULL)? rows[r]: r;
+        sum = 0.0;
+        for (size_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            sum += A->val[k] * x[A->col[k]];
+        }
+        x_new[i] = x[i] + inv_diag[i] * (b[i] - sum);
+        diff += (x_new[i] - x[i]) * (x_new[i] - x[i]);
+    }
+
+    return diff;
+}
+
+/**
+ * @brief Jacobi method for a sparse system Ax=b.
+ *
+ * Starts from x=0 and stops on the same rule as `jacobi_dense`.
+ *
+ * @param A Matrix
+ * @param b Known terms
+ * @param x Solution
+ * @param eps Error in applicating Jacobi method
+ * @return int Number of Jacobi method iterations, -1 if a diagonal
+ * element is missing or zero
+ */
+int jacobi_sparse(struct csr *A, double *b, double *x, double *eps) {
+    int n = A->rows;
+    int itr = 0;
+    double diff;
+    double *inv_diag = malloc(n * sizeof *inv_diag);
+    double *x_new = malloc(n * sizeof *x_new);
+
+    if (csr_inverse_diagonal(A, inv_diag) != 0) {
+        free(inv_diag);
+        free(x_new);
+        return -1;
+    }
+    memset(x, 0, n * sizeof *x);
+    do {
+        diff = csr_sweep(A, b, inv_diag, x, x_new, NULL, n);
+        itr++;
+        diff = sqrt(diff);
+        memcpy(x, x_new, n * sizeof *x);
+    } while (diff > CONVERGENCE_THRESHOLD && itr < MAX_ITERATIONS);
+    free(inv_diag);
+    free(x_new);
+    *eps = diff;
+
+    return itr;
+}
+
+/**
+ * @brief Free memory held by a matrix.
+ *
+ * @param A Matrix
+ */
+void csr_free(struct csr *A) {
+    free(A->row_ptr);
+    free(A->col);
+    free(A->val);
+    A->row_ptr = NULL;
+    A->col = NULL;
+    A->val = NULL;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file dense.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Parallel Jacobi method over dense systems.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "dense.h"
+#include "jacobi.h"
+#include "largecount.h"
+#include "mpiutils.h"
+
+/**
+ * @brief Compute row distribution and allocate local rows.
+ *
+ * Rows are split as evenly as possible, first processes get one more
+ * when the order is not a multiple of processes.
+ *
+ * @param d Dense system to set up
+ * @param comm Communicator of processes sharing the system
+ * @param n Order of the system
+ * @param phases Phase accumulators
+ */
+void dense_create(struct dense *d, MPI_Comm comm, int n, struct phases *phases) {
+    int nproc;
+    int me;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    d->comm = comm;
+    d->nproc = nproc;
+    d->me = me;
+    d->n = n;
+    d->phases = phases;
+    d->max_iterations = MAX_ITERATIONS;
+    d->num_iterations = 0;
+    d->diffnorm = 0.0;
+
+    d->rowcounts = malloc(nproc * sizeof *d->rowcounts);
+    d->rowdispls = malloc(nproc * sizeof *d->rowdispls);
+    d->sendcounts = malloc(nproc * sizeof *d->sendcounts);
+    d->senddispls = malloc(nproc * sizeof *d->senddispls);
+    for (int p = 0; p < nproc; p++) {
+        d->rowcounts[p] = n / nproc + (p < n % nproc);
+        d->rowdispls[p] = (p == 0)? 0: d->rowdispls[p - 1] + d->rowcounts[p - 1];
+        d->sendcounts[p] = (size_t) d->rowcounts[p] * n;
+        d->senddispls[p] = (size_t) d->rowdispls[p] * n;
+    }
+    d->local_rows = d->rowcounts[me];
+    d->first_row = d->rowdispls[me];
+
+    d->local_A = malloc((size_t) d->local_rows * n * sizeof *d->local_A);
+    d->local_b = malloc(d->local_rows * sizeof *d->local_b);
+    d->inv_diag = malloc(d->local_rows * sizeof *d->inv_diag);
+    d->x = malloc(n * sizeof *d->x);
+    d->x_new = malloc(d->local_rows * sizeof *d->x_new);
+}
+
+/**
+ * @brief Distribute row blocks and known terms from MASTER to every process.
+ *
+ * @param d Dense system
+ * @param A Whole matrix (significant on MASTER only)
+ * @param b Whole known terms (significant on MASTER only)
+ */
+void dense_scatter(struct dense *d, double *A, double *b) {
+    phases_start(d->phases);
+    scatterv_large(
+        A, d->sendcounts, d->senddispls, MPI_DOUBLE,
+        d->local_A, MASTER, d->comm
+    );
+    MPI_Scatterv(
+        b, d->rowcounts, d->rowdispls, MPI_DOUBLE,
+        d->local_b, d->local_rows, MPI_DOUBLE,
+        MASTER, d->comm
+    );
+    inverse_diagonal(d->local_A, d->inv_diag, d->local_rows, d->n, d->first_row);
+    phases_lap(d->phases, PHASE_SCATTER);
+}
+
+/**
+ * @brief Apply Jacobi method over local rows until convergence.
+ *
+ * Every iteration needs the whole solution, so local updates are
+ * gathered by every process; the solution is left on every process.
+ *
+ * @param d Dense system
+ */
+void dense_iterate(struct dense *d) {
+    double local_diffnorm;
+    double diffnorm;
+    int num_iterations = 0;
+
+    phases_start(d->phases);
+    memset(d->x, 0, d->n * sizeof *d->x);
+    do {
+        local_diffnorm = dense_sweep(
+            d->local_A, d->local_b, d->inv_diag, d->x, d->x_new,
+            d->local_rows, d->n, d->first_row
+        );
+        num_iterations++;
+        phases_lap(d->phases, PHASE_SWEEP);
+
+        MPI_Allreduce(
+            &local_diffnorm, &diffnorm, 1,
+            MPI_DOUBLE, MPI_SUM, d->comm
+        );
+        diffnorm = sqrt(diffnorm);
+        phases_lap(d->phases, PHASE_ALLREDUCE);
+
+        MPI_Allgatherv(
+            d->x_new, d->local_rows, MPI_DOUBLE,
+            d->x, d->rowcounts, d->rowdispls, MPI_DOUBLE,
+            d->comm
+        );
+        phases_lap(d->phases, PHASE_EXCHANGE);
+    } while (
+        diffnorm > CONVERGENCE_THRESHOLD &&
+        num_iterations < d->max_iterations
+    );
+
+    d->num_iterations = num_iterations;
+    d->diffnorm = diffnorm;
+}
+
+/**
+ * @brief Free local rows and describers.
+ *
+ * @param d Dense system
+ */
+void dense_free(struct dense *d) {
+    free(d->local_A);
+    free(d->local_b);
+    free(d->inv_diag);
+    free(d->x);
+    free(d->x_new);
+    free(d->rowcounts);
+    free(d->rowdispls);
+    free(d->sendcounts);
+    free(d->senddispls);
+}
@@ -0,0 +1,344 @@
+/**
+ * @file farm.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Task farm of independent grid solutions.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "compress.h"
+#include "farm.h"
+#include "halo.h"
+#include "jacobi.h"
+#include "matrixutils.h"
+#include "misc.h"
+#include "mpiutils.h"
+#include "phases.h"
+#include "regress.h"
+#include "slab.h"
+
+/**
+ * @brief Read jobs from file.
+ *
+ * Every job is a `<matrixOrder> [<seed>]` line, blank lines and lines
+ * starting with `#` are skipped; jobs with no seed get one of their
+ * own, so that no two of them solve the same grid.
+ *
+ * @param job_file Job file
+ * @param jobs Jobs read, to be freed by caller
+ * @return int Number of jobs, -1 if file cannot be read or is malformed
+ */
+int farm_read(const char *job_file, struct farm_job **jobs) {
+    FILE *file = fopen(job_file, "r");
+    char line[256];
+    int count = 0;
+    int capacity = 16;
+    int fields;
+    char first;
+
+    if (file == NULL) {
+        return -1;
+    }
+    *jobs = malloc(capacity * sizeof **jobs);
+    while (fgets(line, sizeof line, file) != NULL) {
+        if (sscanf(line, " %c", &first) != 1 || first == '#') {
+            continue;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            *jobs = realloc(*jobs, capacity * sizeof **jobs);
+        }
+        fields = sscanf(line, "%d %d", &(*jobs)[count].n, &(*jobs)[count].seed);
+        if (fields < 1 || (*jobs)[count].n < 3) {
+            fclose(file);
+            free(*jobs);
+            *jobs = NULL;
+            return -1;
+        }
+        if (fields == 1) {
+            (*jobs)[count].seed = SEED + count;
+        }
+        count++;
+    }
+    fclose(file);
+
+    return count;
+}
+
+/**
+ * @brief Split processes into groups and set up job counter.
+ *
+ * Consecutive ranks make a group, the last one gets whatever
+ * processes are left. Collective over the communicator.
+ *
+ * @param f Farm
+ * @param comm Communicator of every process
+ * @param group_size Processes of every group
+ * @param jobs Jobs to solve (significant on every process)
+ * @param job_count Number of jobs
+ */
+void farm_create(
+    struct farm *f,
+    MPI_Comm comm,
+    int group_size,
+    struct farm_job *jobs,
+    int job_count
+) {
+    int nproc;
+    int me;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    if (group_size > nproc) {
+        group_size = nproc;
+    }
+    f->comm = comm;
+    f->group_id = me / group_size;
+    f->group_count = (nproc + group_size - 1) / group_size;
+    MPI_Comm_split(comm, f->group_id, me, &f->group);
+    MPI_Comm_size(f->group, &f->group_size);
+    f->leader = me % group_size == 0;
+    f->jobs = jobs;
+    f->job_count = job_count;
+    f->records = calloc((size_t) job_count * FARM_FIELDS, sizeof *f->records);
+    f->done = 0;
+    f->busy = 0.0;
+    f->seconds = 0.0;
+    f->failed = 0;
+
+    // only MASTER holds the counter, leaders update it atomically
+    MPI_Win_allocate(
+        (me == MASTER)? sizeof *f->next: 0, sizeof *f->next, MPI_INFO_NULL,
+        comm, &f->next, &f->next_win
+    );
+    if (me == MASTER) {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, MASTER, 0, f->next_win);
+        *f->next = 0;
+        MPI_Win_unlock(MASTER, f->next_win);
+    }
+    MPI_Barrier(comm);
+    MPI_Win_lock_all(0, f->next_win);
+}
+
+/**
+ * @brief Take next job for this group.
+ *
+ * Collective over the group.
+ *
+ * @param f Farm
+ * @return int Job index, -1 if no job is left
+ */
+static int farm_next(struct farm *f) {
+    int one = 1;
+    int next = 0;
+
+    if (f->leader) {
+        MPI_Fetch_and_op(&one, &next, MPI_INT, MASTER, 0, MPI_SUM, f->next_win);
+        MPI_Win_flush(MASTER, f->next_win);
+    }
+    MPI_Bcast(&next, 1, MPI_INT, MASTER, f->group);
+
+    return (next < f->job_count)? next: -1;
+}
+
+/**
+ * @brief Solve jobs until none is left.
+ *
+ * Every group solves a job at a time with the slab solver, leader
+ * generating its matrix and getting its solution. Time of a job spans
+ * from generation to gather, and verification when asked. Collective
+ * over the communicator of every process.
+ *
+ * @param f Farm
+ * @param backend Ghost rows exchange backend
+ * @param compress Ghost rows compression mode
+ * @param verify Whether to check solutions against serial ones
+ */
+void farm_run(struct farm *f, int backend, int compress, unsigned char verify) {
+    struct slab slab;
+    struct phases phases;
+    double *A = NULL;
+    double *A_0 = NULL;
+    double *reference;
+    double reference_err;
+    double max_difference;
+    int reference_iterations;
+    double t_start;
+    double job_start;
+    double *record;
+    int job;
+    int n;
+
+    MPI_Barrier(f->comm);
+    t_start = MPI_Wtime();
+    while ((job = farm_next(f)) >= 0) {
+        job_start = MPI_Wtime();
+        n = f->jobs[job].n;
+        if (f->leader) {
+            A = malloc((size_t) n * n * sizeof *A);
+            A_0 = malloc((size_t) n * n * sizeof *A_0);
+            generate_matrix_array(A_0, n, n, LOWER_BOUND, UPPER_BOUND, f->jobs[job].seed);
+            memcpy(A, A_0, n * sizeof *A);
+            memcpy(&A[(size_t) (n - 1) * n], &A_0[(size_t) (n - 1) * n], n * sizeof *A);
+        }
+
+        phases_reset(&phases);
+        slab_create(&slab, f->group, n, 0, &phases, backend);
+        if (compress != COMPRESS_NONE) {
+            halo_compress(&slab.halo, compress);
+        }
+        slab_scatter(&slab, A_0);
+        slab_iterate(&slab);
+        slab_gather(&slab, A);
+
+        if (f->leader && verify) {
+            reference = malloc((size_t) n * n * sizeof *reference);
+            copy_matrix_array(A_0, reference, n, n);
+            reference_iterations = jacobi(reference, n, n, &reference_err);
+            if (!verify_solution(
+                    A, reference, n, n,
+                    (compress == COMPRESS_LOSSY)? CONVERGENCE_THRESHOLD: VERIFY_TOLERANCE,
+                    &max_difference
+                ) ||
+                abs(reference_iterations - slab.num_iterations) > (compress == COMPRESS_LOSSY)) {
+                printf(
+                    "Job %d, n=%d: MISMATCH, %d iterations against %d serial ones, "
+                    "max difference %.3e\n",
+                    job,
+                    n,
+                    slab.num_iterations,
+                    reference_iterations,
+                    max_difference
+                );
+                fflush(stdout);
+                f->failed = 1;
+            }
+            free(reference);
+        }
+
+        if (f->leader) {
+            record = &f->records[(size_t) job * FARM_FIELDS];
+            record[0] = n;
+            record[1] = f->group_id;
+            record[2] = slab.num_iterations;
+            record[3] = slab.diffnorm;
+            record[4] = MPI_Wtime() - job_start;
+            f->busy += record[4];
+            f->done++;
+            free(A);
+            free(A_0);
+        }
+        slab_free(&slab);
+    }
+    f->seconds = MPI_Wtime() - t_start;
+
+    // farm lasts as long as its slowest group
+    MPI_Allreduce(MPI_IN_PLACE, &f->seconds, 1, MPI_DOUBLE, MPI_MAX, f->comm);
+    MPI_Allreduce(MPI_IN_PLACE, &f->failed, 1, MPI_INT, MPI_MAX, f->comm);
+}
+
+/**
+ * @brief Print throughput and per-group utilization, and write every
+ * job to results file.
+ *
+ * Utilization of a group is the share of farm time it spent on jobs.
+ * Collective over the communicator of every process.
+ *
+ * @param f Farm
+ * @param output_file Results file name (significant on MASTER only)
+ * @return int 0 on success, -1 if file cannot be written (on MASTER only)
+ */
+int farm_report(struct farm *f, const char *output_file) {
+    int nproc;
+    int me;
+    double figures[3];
+    double *groups = NULL;
+    double *records = NULL;
+    FILE *results;
+    int status = 0;
+
+    MPI_Comm_size(f->comm, &nproc);
+    MPI_Comm_rank(f->comm, &me);
+    // every job was solved by a single group
+    if (me == MASTER) {
+        groups = malloc(3 * nproc * sizeof *groups);
+        records = malloc((size_t) f->job_count * FARM_FIELDS * sizeof *records);
+    }
+    MPI_Reduce(
+        f->records, records, f->job_count * FARM_FIELDS, MPI_DOUBLE, MPI_SUM,
+        MASTER, f->comm
+    );
+    figures[0] = f->leader;
+    figures[1] = f->done;
+    figures[2] = f->busy;
+    MPI_Gather(figures, 3, MPI_DOUBLE, groups, 3, MPI_DOUBLE, MASTER, f->comm);
+
+    if (me == MASTER) {
+        printf(
+            "Task farm: %d jobs over %d groups in %.3f s, %.1f jobs/hour\n",
+            f->job_count,
+            f->group_count,
+            f->seconds,
+            f->job_count / f->seconds * 3600
+        );
+        for (int p = 0; p < nproc; p++) {
+            if (groups[3 * p] == 0.0) {
+                continue;
+            }
+            printf(
+                "Group %d (P%d, %d processes): %.0f jobs, %.3f s busy, %.1f%% utilization\n",
+                p / f->group_size,
+                p,
+                (p + f->group_size <= nproc)? f->group_size: nproc - p,
+                groups[3 * p + 1],
+                groups[3 * p + 2],
+                groups[3 * p + 2] / f->seconds * 100
+            );
+        }
+        printf("\n");
+        fflush(stdout);
+
+        results = fopen(output_file, "w");
+        if (results == NULL) {
+            status = -1;
+        } else {
+            fprintf(results, "\"Job\",\"Size\",\"Group\",\"Iterations\",\"Error\",\"Time\"\n");
+            for (int j = 0; j < f->job_count; j++) {
+                double *record = &records[(size_t) j * FARM_FIELDS];
+
+                fprintf(
+                    results, "%d,%.0f,%.0f,%.0f,%e,%f\n",
+                    j, record[0], record[1], record[2], record[3], record[4]
+                );
+            }
+            fclose(results);
+        }
+    }
+    free(groups);
+    free(records);
+
+    return status;
+}
+
+/**
+ * @brief Free memory and communicators held by a farm.
+ *
+ * Collective over the communicator of every process.
+ *
+ * @param f Farm
+ */
+void farm_free(struct farm *f) {
+    MPI_Win_unlock_all(f->next_win);
+    MPI_Win_free(&f->next_win);
+    MPI_Comm_free(&f->group);
+    free(f->records);
+    f->records = NULL;
+}
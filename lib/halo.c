@@ -0,0 +1,604 @@
+/**
+ * @file halo.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Ghost rows exchange backends.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _XOPEN_SOURCE 700 /**< Use sched_yield definition from POSIX */
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "halo.h"
+#include "mpiutils.h"
+
+/**
+ * @brief Backend names as given on command line.
+ *
+ * Backend names as given on command line.
+ */
+const char *HALO_NAMES[HALO_COUNT] = {
+    "sendrecv",
+    "shm",
+    "rma",
+    "neighbor"
+};
+
+/**
+ * @brief Synchronization flags of a process in shared window.
+ *
+ * Every process publishes the number of exchanges its unghosted rows
+ * are ready for, while neighbours acknowledge rows they took; flags of
+ * different processes lay on different cache lines.
+ */
+enum halo_flag {
+    FLAG_PUBLISHED,     /**< Exchanges whose rows are ready */
+    FLAG_TAKEN_BY_UP,   /**< Exchanges whose first row previous process took */
+    FLAG_TAKEN_BY_DOWN, /**< Exchanges whose last row next process took */
+    FLAG_STRIDE = 16    /**< Flags of a process, padded to a cache line */
+};
+
+/**
+ * @brief Get exchange backend from its name.
+ *
+ * @param name Backend name, NULL for default one
+ * @return int Backend, -1 if unknown
+ */
+int halo_parse(char *name) {
+    if (name == NULL) {
+        return HALO_SENDRECV;
+    }
+    for (int b = 0; b < HALO_COUNT; b++) {
+        if (strcmp(name, HALO_NAMES[b]) == 0) {
+            return b;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Map neighbours into shared windows, if they share memory with us.
+ *
+ * @param h Exchange state
+ * @param counts Scatter counts of every process
+ */
+static void shm_create(struct halo *h, size_t *counts) {
+    MPI_Group group;
+    MPI_Group node_group;
+    MPI_Info info;
+    MPI_Aint size;
+    int disp_unit;
+    double *base;
+    int *flags;
+    int neighbours[2] = {h->up, h->down};
+    int node_ranks[2];
+
+    MPI_Comm_split_type(h->comm, MPI_COMM_TYPE_SHARED, h->me, MPI_INFO_NULL, &h->node);
+    // let every segment be allocated close to its owner
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+    MPI_Win_allocate_shared(
+        counts[h->me] * sizeof *h->prime, sizeof *h->prime, info,
+        h->node, &h->prime, &h->data_win
+    );
+    MPI_Win_allocate_shared(
+        FLAG_STRIDE * sizeof *flags, sizeof *flags, info,
+        h->node, &flags, &h->flag_win
+    );
+    MPI_Info_free(&info);
+    h->flags = flags;
+
+    // find out which neighbours are on this node
+    MPI_Comm_group(h->comm, &group);
+    MPI_Comm_group(h->node, &node_group);
+    for (int i = 0; i < 2; i++) {
+        node_ranks[i] = MPI_UNDEFINED;
+        if (neighbours[i] != MPI_PROC_NULL) {
+            MPI_Group_translate_ranks(group, 1, &neighbours[i], node_group, &node_ranks[i]);
+        }
+    }
+    MPI_Group_free(&group);
+    MPI_Group_free(&node_group);
+
+    if (node_ranks[0] != MPI_UNDEFINED) {
+        MPI_Win_shared_query(h->data_win, node_ranks[0], &size, &disp_unit, &base);
+        h->up_row = base + (counts[h->up]/h->n - 2) * h->n;
+        MPI_Win_shared_query(h->flag_win, node_ranks[0], &size, &disp_unit, &flags);
+        h->up_flags = flags;
+    }
+    if (node_ranks[1] != MPI_UNDEFINED) {
+        MPI_Win_shared_query(h->data_win, node_ranks[1], &size, &disp_unit, &base);
+        h->down_row = base + h->n;
+        MPI_Win_shared_query(h->flag_win, node_ranks[1], &size, &disp_unit, &flags);
+        h->down_flags = flags;
+    }
+
+    // flags are read and written with plain loads and stores,
+    // MPI_Win_sync makes them visible within a passive epoch
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, h->data_win);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, h->flag_win);
+    for (int i = 0; i < FLAG_STRIDE; i++) {
+        h->flags[i] = 0;
+    }
+    MPI_Win_sync(h->flag_win);
+    MPI_Barrier(h->node);
+    MPI_Win_sync(h->flag_win);
+}
+
+/**
+ * @brief Expose submatrix after iteration in a window for neighbours.
+ *
+ * @param h Exchange state
+ * @param counts Scatter counts of every process
+ */
+static void rma_create(struct halo *h, size_t *counts) {
+    MPI_Group group;
+    MPI_Info info;
+    int ranks[2];
+    int count = 0;
+
+    // ghost rows are only written by neighbours within
+    // post-start-complete-wait epochs, no locks are needed
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "no_locks", "true");
+    MPI_Win_allocate(
+        counts[h->me] * sizeof *h->prime, sizeof *h->prime, info,
+        h->comm, &h->prime, &h->data_win
+    );
+    MPI_Info_free(&info);
+
+    if (h->up != MPI_PROC_NULL) {
+        ranks[count++] = h->up;
+        h->up_ghost = (counts[h->up]/h->n - 1) * h->n;
+    }
+    if (h->down != MPI_PROC_NULL) {
+        ranks[count++] = h->down;
+    }
+    MPI_Comm_group(h->comm, &group);
+    MPI_Group_incl(group, count, ranks, &h->neighbours);
+    MPI_Group_free(&group);
+}
+
+/**
+ * @brief Set up ghost rows exchange and allocate submatrix after iteration.
+ *
+ * Collective over the communicator.
+ *
+ * @param h Exchange state
+ * @param comm Communicator of processes sharing the matrix
+ * @param n Matrix order
+ * @param counts Scatter counts of every process, ghost rows included
+ * @param backend Exchange backend
+ * @param debug Debug flag
+ */
+void halo_create(
+    struct halo *h,
+    MPI_Comm comm,
+    int n,
+    size_t *counts,
+    enum halo_backend backend,
+    unsigned char debug
+) {
+    int nproc;
+
+    memset(h, 0, sizeof *h);
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &h->me);
+    h->backend = backend;
+    h->comm = comm;
+    h->n = n;
+    h->debug = debug;
+    if (backend == HALO_NEIGHBOR) {
+        // neighbours as the topology sees them
+        MPI_Cart_shift(comm, 0, 1, &h->up, &h->down);
+    } else {
+        h->up = (h->me != MASTER)? h->me - 1: MPI_PROC_NULL;
+        h->down = (h->me != nproc - 1)? h->me + 1: MPI_PROC_NULL;
+    }
+    h->first_g_row = n;
+    h->last_g_row = (counts[h->me]/n - 2) * n;
+    h->last_local_row = h->last_g_row + n;
+    h->node = MPI_COMM_NULL;
+
+    switch (backend) {
+        case HALO_SHM:
+            shm_create(h, counts);
+            break;
+        case HALO_RMA:
+            rma_create(h, counts);
+            break;
+        default:
+            h->prime = malloc(counts[h->me] * sizeof *h->prime);
+            break;
+    }
+    memset(h->prime, 0, counts[h->me] * sizeof *h->prime);
+    if (backend == HALO_SHM) {
+        MPI_Win_sync(h->data_win);
+        MPI_Barrier(h->node);
+    }
+}
+
+/**
+ * @brief Compress rows exchanged as messages.
+ *
+ * Applies to `sendrecv` backend and to neighbours on other nodes of
+ * `shm` backend; codec references start as zero rows at both ends.
+ *
+ * @param h Exchange state
+ * @param mode Compression mode
+ */
+void halo_compress(struct halo *h, enum compress_mode mode) {
+    compress_create(&h->codec, mode, h->n);
+    for (int side = 0; side < 2; side++) {
+        h->sent[side] = calloc(h->n, sizeof *h->sent[side]);
+        h->received[side] = calloc(h->n, sizeof *h->received[side]);
+    }
+    h->packed = malloc(compress_bound(h->n));
+    h->unpacked = malloc(compress_bound(h->n));
+}
+
+/**
+ * @brief Polls of a flag before giving up the processor.
+ */
+static const int SPIN_POLLS = 64;
+
+/**
+ * @brief Spin until a flag reaches the current exchange.
+ *
+ * The processor is yielded every few polls, so that oversubscribed
+ * neighbours can make progress.
+ *
+ * @param h Exchange state
+ * @param flag Flag to watch
+ */
+static void shm_wait(struct halo *h, volatile int *flag) {
+    for (int polls = 1; *flag < h->epoch; polls++) {
+        if (polls % SPIN_POLLS == 0) {
+            sched_yield();
+        }
+        MPI_Win_sync(h->flag_win);
+    }
+}
+
+/**
+ * @brief Exchange a compressed row with a neighbour via message.
+ *
+ * @param h Exchange state
+ * @param side 0 for previous process, 1 for next one
+ * @param peer Neighbour process
+ * @param send_row Unghosted row to send
+ * @param recv_row Ghost row to receive
+ */
+static void sendrecv_packed(
+    struct halo *h,
+    int side,
+    int peer,
+    double *send_row,
+    double *recv_row
+) {
+    MPI_Status status;
+    size_t packed;
+    int unpacked;
+
+    packed = compress_row(&h->codec, send_row, h->sent[side], h->packed);
+    MPI_Sendrecv(
+        h->packed, (int) packed, MPI_BYTE, peer, TAG,
+        h->unpacked, (int) compress_bound(h->n), MPI_BYTE, peer, TAG,
+        h->comm, &status
+    );
+    MPI_Get_count(&status, MPI_BYTE, &unpacked);
+    if (expand_row(&h->codec, h->unpacked, unpacked, recv_row, h->received[side]) != 0) {
+        fprintf(stderr, "\a[P%d] Malformed row from process %d!\n", h->me, peer);
+        MPI_Abort(h->comm, EXIT_FAILURE);
+    }
+    h->raw_bytes += h->n * sizeof *send_row;
+    h->packed_bytes += packed;
+}
+
+/**
+ * @brief Exchange unghosted rows with previous process via message.
+ *
+ * @param h Exchange state
+ */
+static void sendrecv_up(struct halo *h) {
+    MPI_Status status;
+
+    if (h->debug) {
+        printf("[P%d] Exchanging with process %d\n", h->me, h->up);
+        fflush(stdout);
+    }
+
+    if (h->codec.mode != COMPRESS_NONE) {
+        sendrecv_packed(h, 0, h->up, &h->prime[h->first_g_row], h->prime);
+        return;
+    }
+    MPI_Sendrecv(
+        // send first unghosted line to previous process
+        &h->prime[h->first_g_row], h->n, MPI_DOUBLE, h->up, TAG,
+        // receive first line from previous process
+        // and put it as my first ghosted line
+        h->prime, h->n, MPI_DOUBLE, h->up, TAG,
+        h->comm, &status
+    );
+}
+
+/**
+ * @brief Exchange unghosted rows with next process via message.
+ *
+ * @param h Exchange state
+ */
+static void sendrecv_down(struct halo *h) {
+    MPI_Status status;
+
+    if (h->debug) {
+        printf("[P%d] Exchanging with process %d\n", h->me, h->down);
+        fflush(stdout);
+    }
+
+    if (h->codec.mode != COMPRESS_NONE) {
+        sendrecv_packed(
+            h, 1, h->down, &h->prime[h->last_g_row], &h->prime[h->last_local_row]
+        );
+        return;
+    }
+    MPI_Sendrecv(
+        // send last unghosted line to next process
+        &h->prime[h->last_g_row], h->n, MPI_DOUBLE, h->down, TAG,
+        // receive last line from next process
+        // and put it as my last ghosted line
+        &h->prime[h->last_local_row], h->n, MPI_DOUBLE, h->down, TAG,
+        h->comm, &status
+    );
+}
+
+/**
+ * @brief Exchange ghost rows through shared memory with on-node
+ * neighbours and through messages with other ones.
+ *
+ * Rows of this process are published, then neighbour rows get copied
+ * as soon as they are published; before returning, this process waits
+ * for on-node neighbours to take its rows, since next iteration
+ * overwrites them.
+ *
+ * @param h Exchange state
+ */
+static void shm_exchange(struct halo *h) {
+    int n = h->n;
+
+    h->epoch++;
+    MPI_Win_sync(h->data_win);
+    h->flags[FLAG_PUBLISHED] = h->epoch;
+    MPI_Win_sync(h->flag_win);
+
+    if (h->up != MPI_PROC_NULL && h->up_row == NULL) {
+        sendrecv_up(h);
+    }
+    if (h->down != MPI_PROC_NULL && h->down_row == NULL) {
+        sendrecv_down(h);
+    }
+
+    if (h->up_row != NULL) {
+        shm_wait(h, &h->up_flags[FLAG_PUBLISHED]);
+        MPI_Win_sync(h->data_win);
+        memcpy(h->prime, h->up_row, n * sizeof *h->prime);
+        h->up_flags[FLAG_TAKEN_BY_DOWN] = h->epoch;
+    }
+    if (h->down_row != NULL) {
+        shm_wait(h, &h->down_flags[FLAG_PUBLISHED]);
+        MPI_Win_sync(h->data_win);
+        memcpy(&h->prime[h->last_local_row], h->down_row, n * sizeof *h->prime);
+        h->down_flags[FLAG_TAKEN_BY_UP] = h->epoch;
+    }
+    MPI_Win_sync(h->flag_win);
+
+    if (h->up_row != NULL) {
+        shm_wait(h, &h->flags[FLAG_TAKEN_BY_UP]);
+    }
+    if (h->down_row != NULL) {
+        shm_wait(h, &h->flags[FLAG_TAKEN_BY_DOWN]);
+    }
+}
+
+/**
+ * @brief Put unghosted rows into neighbour ghost rows.
+ *
+ * Access and exposure epochs only involve previous and next process,
+ * so that no process waits for the whole communicator.
+ *
+ * @param h Exchange state
+ */
+static void rma_exchange(struct halo *h) {
+    int n = h->n;
+
+    MPI_Win_post(h->neighbours, 0, h->data_win);
+    MPI_Win_start(h->neighbours, 0, h->data_win);
+    if (h->up != MPI_PROC_NULL) {
+        // first unghosted line becomes last ghosted line of previous process
+        MPI_Put(
+            &h->prime[h->first_g_row], n, MPI_DOUBLE,
+            h->up, h->up_ghost, n, MPI_DOUBLE, h->data_win
+        );
+    }
+    if (h->down != MPI_PROC_NULL) {
+        // last unghosted line becomes first ghosted line of next process
+        MPI_Put(
+            &h->prime[h->last_g_row], n, MPI_DOUBLE,
+            h->down, 0, n, MPI_DOUBLE, h->data_win
+        );
+    }
+    MPI_Win_complete(h->data_win);
+    MPI_Win_wait(h->data_win);
+}
+
+/**
+ * @brief Exchange rows with both topology neighbours in one operation.
+ *
+ * Rows are given by absolute address, so that sent and received rows
+ * may lay in the same buffer.
+ *
+ * @param topology Cartesian communicator
+ * @param n Row length
+ * @param send_up Row to send to previous process
+ * @param send_down Row to send to next process
+ * @param recv_up Row to receive from previous process
+ * @param recv_down Row to receive from next process
+ */
+static void neighbor_exchange(
+    MPI_Comm topology,
+    int n,
+    double *send_up,
+    double *send_down,
+    double *recv_up,
+    double *recv_down
+) {
+    // Cartesian neighbours come as previous, then next one
+    int counts[2] = {n, n};
+    MPI_Aint send_displs[2];
+    MPI_Aint recv_displs[2];
+    MPI_Datatype types[2] = {MPI_DOUBLE, MPI_DOUBLE};
+
+    MPI_Get_address(send_up, &send_displs[0]);
+    MPI_Get_address(send_down, &send_displs[1]);
+    MPI_Get_address(recv_up, &recv_displs[0]);
+    MPI_Get_address(recv_down, &recv_displs[1]);
+    MPI_Neighbor_alltoallw(
+        MPI_BOTTOM, counts, send_displs, types,
+        MPI_BOTTOM, counts, recv_displs, types,
+        topology
+    );
+}
+
+/**
+ * @brief Exchange ghost rows with previous and next process.
+ *
+ * @param h Exchange state
+ */
+void halo_exchange(struct halo *h) {
+    switch (h->backend) {
+        case HALO_SHM:
+            shm_exchange(h);
+            break;
+        case HALO_RMA:
+            rma_exchange(h);
+            break;
+        case HALO_NEIGHBOR:
+            // first and last process exchange with MPI_PROC_NULL too
+            neighbor_exchange(
+                h->comm,
+                h->n,
+                &h->prime[h->first_g_row],
+                &h->prime[h->last_g_row],
+                h->prime,
+                &h->prime[h->last_local_row]
+            );
+            break;
+        default:
+            // P0 has no previous one
+            if (h->up != MPI_PROC_NULL) {
+                sendrecv_up(h);
+            }
+            // Pnproc-1 has no next one
+            if (h->down != MPI_PROC_NULL) {
+                sendrecv_down(h);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Count neighbours exchanging rows through shared memory.
+ *
+ * @param h Exchange state
+ * @return int Number of on-node neighbours, 0 to 2
+ */
+int halo_on_node(struct halo *h) {
+    return (h->up_row != NULL) + (h->down_row != NULL);
+}
+
+/**
+ * @brief Release exchange resources and submatrix after iteration.
+ *
+ * Collective over the communicator.
+ *
+ * @param h Exchange state
+ */
+void halo_free(struct halo *h) {
+    if (h->backend == HALO_SHM) {
+        MPI_Win_unlock_all(h->flag_win);
+        MPI_Win_unlock_all(h->data_win);
+        MPI_Win_free(&h->flag_win);
+        MPI_Win_free(&h->data_win);
+        MPI_Comm_free(&h->node);
+    } else if (h->backend == HALO_RMA) {
+        MPI_Win_free(&h->data_win);
+        MPI_Group_free(&h->neighbours);
+    } else {
+        free(h->prime);
+    }
+    h->prime = NULL;
+    if (h->codec.mode != COMPRESS_NONE) {
+        compress_free(&h->codec);
+        for (int side = 0; side < 2; side++) {
+            free(h->sent[side]);
+            free(h->received[side]);
+        }
+        free(h->packed);
+        free(h->unpacked);
+    }
+}
+
+/**
+ * @brief Arrange processes in a chain topology for neighbour exchange.
+ *
+ * Collective over the communicator.
+ *
+ * @param comm Communicator of processes sharing the matrix
+ * @param reorder Whether MPI library may rank processes anew
+ * @param topology Non-periodic 1D Cartesian communicator
+ */
+void halo_topology(MPI_Comm comm, int reorder, MPI_Comm *topology) {
+    int nproc;
+    int periods = 0;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Cart_create(comm, 1, &nproc, &periods, reorder, topology);
+}
+
+/**
+ * @brief Measure ghost rows exchange over a topology.
+ *
+ * Collective over the topology.
+ *
+ * @param topology Cartesian communicator
+ * @param n Row length
+ * @param rounds Timed exchanges
+ * @return double Seconds per exchange of slowest process (on MASTER only)
+ */
+double halo_probe(MPI_Comm topology, int n, int rounds) {
+    double *rows = calloc(4 * n, sizeof *rows);
+    double t_start = 0.0;
+    double elapsed;
+    double t_max = 0.0;
+
+    // first exchange is left out
+    for (int r = -1; r < rounds; r++) {
+        if (r == 0) {
+            MPI_Barrier(topology);
+            t_start = MPI_Wtime();
+        }
+        neighbor_exchange(topology, n, &rows[n], &rows[2 * n], rows, &rows[3 * n]);
+    }
+    elapsed = (MPI_Wtime() - t_start) / rounds;
+    MPI_Reduce(&elapsed, &t_max, 1, MPI_DOUBLE, MPI_MAX, MASTER, topology);
+    free(rows);
+
+    return t_max;
+}
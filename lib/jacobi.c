@@ -20,6 +20,7 @@
 #include "matrixutils.h"
 #include "jacobi.h"
 #include "mpiutils.h"
+#include "perfcounters.h"
 
 extern const short MAX_ITERATIONS; /**< Maximum number of iterations allowed */
 extern const double CONVERGENCE_THRESHOLD; /**< Error threshold */
@@ -37,19 +38,26 @@ int jacobi(double *A, int rows, int columns, double *eps) {
     int itr;
     double diff;
     double *A_prime;
+    double cells = (rows - 2) * (double) (columns - 2);
 
     itr = 0;
-    A_prime = malloc(rows * columns * sizeof *A_prime);
-    memset(A_prime, 0, rows * columns);
+    A_prime = malloc((size_t) rows * columns * sizeof *A_prime);
+    memset(A_prime, 0, (size_t) rows * columns * sizeof *A_prime);
     do {
+        counters_begin();
         jacobi_iteration(A, A_prime, rows, columns);
+        counters_end(KERNEL_SWEEP, cells);
         itr++;
         // calculate convergence value
+        counters_begin();
         diff = convergence_check_g(A, A_prime, rows, columns);
+        counters_end(KERNEL_RESIDUAL, cells);
         diff = sqrt(diff);
         // swap matrices
         // swap_pointers(&A, &A_prime);
+        counters_begin();
         replace_elements(A, A_prime, rows, columns);
+        counters_end(KERNEL_COPY, cells);
         // debug printing
         // printf("Matrix at iteration %d:\n", itr);
         // print_matrix_array(A, rows, columns);
@@ -63,6 +71,167 @@ int jacobi(double *A, int rows, int columns, double *eps) {
     return itr;
 }
 
+/**
+ * @brief Mode names as given on command line.
+ *
+ * Mode names as given on command line.
+ */
+const char *JACOBI_MODE_NAMES[JACOBI_MODE_COUNT] = {
+    "grid",
+    "dense",
+    "sparse",
+    "active"
+};
+
+/**
+ * @brief Get problem mode from its name.
+ *
+ * @param name Mode name, NULL for grid
+ * @return int Mode, -1 if unknown
+ */
+int jacobi_mode_parse(char *name) {
+    if (name == NULL) {
+        return JACOBI_GRID;
+    }
+    for (int m = 0; m < JACOBI_MODE_COUNT; m++) {
+        if (strcmp(name, JACOBI_MODE_NAMES[m]) == 0) {
+            return m;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Jacobi method for a dense system Ax=b.
+ *
+ * Starts from x=0 and stops on the same rule as grid solution,
+ * over the norm of the update of x.
+ *
+ * @param A Diagonally dominant coefficient matrix, n by n
+ * @param b Known terms
+ * @param x Solution
+ * @param n Order of the system
+ * @param eps Error in applicating Jacobi method
+ * @return int Number of Jacobi method iterations
+ */
+int jacobi_dense(double *A, double *b, double *x, int n, double *eps) {
+    int itr = 0;
+    double diff;
+    double *inv_diag = malloc(n * sizeof *inv_diag);
+    double *x_new = malloc(n * sizeof *x_new);
+
+    inverse_diagonal(A, inv_diag, n, n, 0);
+    memset(x, 0, n * sizeof *x);
+    do {
+        diff = dense_sweep(A, b, inv_diag, x, x_new, n, n, 0);
+        itr++;
+        diff = sqrt(diff);
+        memcpy(x, x_new, n * sizeof *x);
+    } while (diff > CONVERGENCE_THRESHOLD && itr < MAX_ITERATIONS);
+    free(inv_diag);
+    free(x_new);
+    *eps = diff;
+
+    return itr;
+}
+
+/**
+ * @brief Inverse of the diagonal of a block of rows.
+ *
+ * @param A Block of rows, n elements each
+ * @param inv_diag Inverse diagonal elements
+ * @param rows Number of rows in block
+ * @param n Order of the system
+ * @param first_row Global index of first row in block
+ */
+void inverse_diagonal(double *A, double *inv_diag, int rows, int n, int first_row) {
+    for (int i = 0; i < rows; i++) {
+        inv_diag[i] = 1.0 / A[(size_t) i * n + first_row + i];
+    }
+}
+
+/**
+ * @brief A single Jacobi iteration over a block of rows of Ax=b.
+ *
+ * Updates are computed as x_i + (b_i - a_i x) / a_ii. Columns are
+ * swept in blocks of `DENSE_BLOCK`, so that their slice of x is read
+ * from cache by every row, and four rows at a time share every load of
+ * it. Each row sums its columns in order whatever the blocking, so any
+ * row distribution gives the same bits.
+ *
+ * @param A Block of rows, n elements each
+ * @param b Known terms of the block
+ * @param inv_diag Inverse diagonal elements of the block
+ * @param x Whole solution before iteration
+ * @param x_new Solution of the block after iteration
+ * @param rows Number of rows in block
+ * @param n Order of the system
+ * @param first_row Global index of first row in block
+ * @return double Squared norm of the update of the block
+ */
+double dense_sweep(
+    double *A,
+    double *b,
+    double *inv_diag,
+    double *x,
+    double *x_new,
+    int rows,
+    int n,
+    int first_row
+) {
+    double diff = 0.0;
+    double old;
+    int i;
+
+    // x_new accumulates row products until the update
+    for (i = 0; i < rows; i++) {
+        x_new[i] = 0.0;
+    }
+    for (int jb = 0; jb < n; jb += DENSE_BLOCK) {
+        int je = (jb + DENSE_BLOCK < n)? jb + DENSE_BLOCK: n;
+
+        for (i = 0; i + 4 <= rows; i += 4) {
+            double *a0 = &A[(size_t) i * n];
+            double *a1 = a0 + n;
+            double *a2 = a1 + n;
+            double *a3 = a2 + n;
+            double s0 = x_new[i];
+            double s1 = x_new[i + 1];
+            double s2 = x_new[i + 2];
+            double s3 = x_new[i + 3];
+
+            for (int j = jb; j < je; j++) {
+                s0 += a0[j] * x[j];
+                s1 += a1[j] * x[j];
+                s2 += a2[j] * x[j];
+                s3 += a3[j] * x[j];
+            }
+            x_new[i] = s0;
+            x_new[i + 1] = s1;
+            x_new[i + 2] = s2;
+            x_new[i + 3] = s3;
+        }
+        for (; i < rows; i++) {
+            double *a = &A[(size_t) i * n];
+            double sum = x_new[i];
+
+            for (int j = jb; j < je; j++) {
+                sum += a[j] * x[j];
+            }
+            x_new[i] = sum;
+        }
+    }
+
+    for (i = 0; i < rows; i++) {
+        old = x[first_row + i];
+        x_new[i] = old + inv_diag[i] * (b[i] - x_new[i]);
+        diff += (x_new[i] - old) * (x_new[i] - old);
+    }
+
+    return diff;
+}
+
 /**
  * @brief A single iteration of Jacobi method.
  * 
@@ -74,6 +243,9 @@ int jacobi(double *A, int rows, int columns, double *eps) {
 void jacobi_iteration(double *A, double *A_prime, int rows, int columns) {
 
     for (int i = 1; i < rows - 1; i++) {
+        // row offsets go past int range on huge grids
+        size_t row = (size_t) i * columns;
+
         for (int j = 1; j < columns - 1; j++) {
             // to perform following check, 'i' and 'j'
             // have to be in range [0, rows|columns]
@@ -85,11 +257,11 @@ void jacobi_iteration(double *A, double *A_prime, int rows, int columns) {
                 // because it retains the original value of number of
                 // rows in the original matrix
                 // TL;DR 'tis the correct offsetting
-                A_prime[i*columns + j] = (
-                    A[(i+1)*columns + j] +
-                    A[(i-1)*columns + j] +
-                    A[i*columns + j+1] +
-                    A[i*columns + j-1]
+                A_prime[row + j] = (
+                    A[row + columns + j] +
+                    A[row - columns + j] +
+                    A[row + j+1] +
+                    A[row + j-1]
                 )/4.0;
             // }
         }
@@ -126,8 +298,10 @@ void swap_pointers(void **a, void **b) {
  */
 void replace_elements(double *a, double *b, int rows, int columns) {
     for (int i = 1; i < rows - 1; i++) {
+        size_t row = (size_t) i * columns;
+
         for (int j = 1; j < columns - 1; j++) {
-            a[i * columns + j] = b[i * columns + j];
+            a[row + j] = b[row + j];
         }
     }
 }
@@ -147,17 +321,17 @@ void replace_partial(
     double *a,
     double *b,
     int columns,
-    int first_element,
-    int last_element,
+    size_t first_element,
+    size_t last_element,
     int process
 ) {
     if (process != 0) {
         first_element = 0;
     }
 
-    for (int i = first_element + 1; i < last_element + columns - 1; i++) {
+    for (size_t i = first_element + 1; i < last_element + columns - 1; i++) {
         // skip replace if I'm on border
-        if (i % columns == 0 || i % columns == columns - 1) continue;
+        if (i % columns == 0 || i % columns == (size_t) columns - 1) continue;
         a[i] = b[i];
     }
 }
@@ -175,11 +349,13 @@ double convergence_check_g(double *x, double *x_prime, int rows, int columns) {
     double diff = 0.0;
 
     for (int i = 1; i < rows - 1; i++) {
+        size_t row = (size_t) i * columns;
+
         for (int j = 1; j < columns - 1; j++) {
             // see jacobi_iteration function for the reason why
             // 'columns' is used instead of 'rows'
-            diff += (x_prime[i*columns+j] - x[i*columns+j]) *
-                (x_prime[i*columns+j] - x[i*columns+j]);
+            diff += (x_prime[row+j] - x[row+j]) *
+                (x_prime[row+j] - x[row+j]);
         }
     }
 
@@ -199,11 +375,13 @@ double convergence_check(double *x, double *x_prime, int rows, int columns) {
     double diff = 0.0;
 
     for (int i = 0; i < rows; i++) {
+        size_t row = (size_t) i * columns;
+
         for (int j = 0; j < columns; j++) {
             // see jacobi_iteration function for the reason why
             // 'columns' is used instead of 'rows'
-            diff += (x_prime[i*columns+j] - x[i*columns+j]) *
-                (x_prime[i*columns+j] - x[i*columns+j]);
+            diff += (x_prime[row+j] - x[row+j]) *
+                (x_prime[row+j] - x[row+j]);
         }
     }
 
@@ -211,23 +389,20 @@ double convergence_check(double *x, double *x_prime, int rows, int columns) {
 }
 
 void scatterv_gatherv_describers(
-    int *scounts,
-    int *sdispls,
-    int *rcounts,
-    int *rdispls,
+    size_t *scounts,
+    size_t *sdispls,
+    size_t *rcounts,
+    size_t *rdispls,
     int *local_rows,
     int nproc,
     int pid,
     int dim
 ) {
     // calculating the number of rows to distribute
-    int rows_per_proc = round(dim / (double) nproc);
-    int rem_rows = (dim % (nproc - 1)) != 0? dim % (nproc - 1): rows_per_proc;
-
-    // according to rows_per_proc rounding, increase remainder
-    if (((double) rows_per_proc) < (dim / (double) nproc)) {
-        rem_rows++;
-    }
+    // last process gets whatever rows are left, so that
+    // no row is either skipped or read past matrix end
+    int rows_per_proc = dim / nproc;
+    int rem_rows = dim - rows_per_proc * (nproc - 1);
 
     // printf(
     //     "Distributing %d of %d matrix rows to %d processes\n",
@@ -247,27 +422,34 @@ void scatterv_gatherv_describers(
 
     for (int i = 0; i < nproc; i++) {
         if (i == MASTER || i == nproc - 1) {
-            scounts[i] = (rows_per_proc + 1) * dim;
+            scounts[i] = (size_t) (rows_per_proc + 1) * dim;
             if (i == MASTER) {
                 sdispls[i] = 0;
                 rdispls[i] = dim;
             }
             else {
-                rdispls[i] = (rows_per_proc) * i * dim;
+                rdispls[i] = (size_t) (rows_per_proc) * i * dim;
                 sdispls[i] = rdispls[i] - dim;
             }
         }
         else {
-            scounts[i] = (rows_per_proc + 2) * dim;
-            rdispls[i] = (rows_per_proc) * i * dim;
+            scounts[i] = (size_t) (rows_per_proc + 2) * dim;
+            rdispls[i] = (size_t) (rows_per_proc) * i * dim;
             sdispls[i] = rdispls[i] - dim;
         }
         rcounts[i] = scounts[i] - 2 * dim;
     }
     // handle last rows for remainder
+    // last row of matrix is a border one and is not recollected
     if (rem_rows != rows_per_proc) {
-        scounts[nproc - 1] = (rem_rows + 1) * dim;
-        rcounts[nproc - 1] = rem_rows * dim;
+        scounts[nproc - 1] = (size_t) (rem_rows + 1) * dim;
+        rcounts[nproc - 1] = (size_t) (rem_rows - 1) * dim;
+    }
+    // a single process is both first and last one, so it
+    // gets the whole matrix and gives back inner rows only
+    if (nproc == 1) {
+        scounts[MASTER] = (size_t) dim * dim;
+        rcounts[MASTER] = (size_t) (dim - 2) * dim;
     }
 
     *local_rows = (pid != nproc - 1)?
@@ -0,0 +1,273 @@
+/**
+ * @file largecount.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Collective transfers past `int` counts.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "largecount.h"
+#include "mpiutils.h"
+
+/**
+ * @brief Whether counts and displacements of every process fit an `int`.
+ *
+ * @param counts Elements of every process
+ * @param displs Displacement of every process, in elements
+ * @param nproc Number of processes
+ * @return int 1 if they fit, 0 otherwise
+ */
+static int fits_int(size_t *counts, size_t *displs, int nproc) {
+    for (int p = 0; p < nproc; p++) {
+        if (counts[p] > LARGE_COUNT_LIMIT || displs[p] > LARGE_COUNT_LIMIT) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+#if MPI_VERSION < 4
+/**
+ * @brief Describe any number of elements as a single derived datatype.
+ *
+ * Elements are grouped into contiguous chunks of `LARGE_CHUNK`, the
+ * remainder is appended to them through a struct type, so that every
+ * count involved fits an `int`.
+ *
+ * @param count Number of elements
+ * @param type Element datatype
+ * @param large Committed datatype of `count` elements
+ */
+static void large_type(size_t count, MPI_Datatype type, MPI_Datatype *large) {
+    MPI_Datatype chunk;
+    MPI_Datatype chunks;
+    MPI_Aint lb;
+    MPI_Aint extent;
+    size_t blocks = count / LARGE_CHUNK;
+    int lengths[2] = {1, (int) (count % LARGE_CHUNK)};
+    MPI_Aint displs[2];
+    MPI_Datatype types[2];
+
+    MPI_Type_get_extent(type, &lb, &extent);
+    MPI_Type_contiguous(LARGE_CHUNK, type, &chunk);
+    MPI_Type_contiguous((int) blocks, chunk, &chunks);
+    displs[0] = 0;
+    displs[1] = (MPI_Aint) (blocks * LARGE_CHUNK) * extent;
+    types[0] = chunks;
+    types[1] = type;
+    MPI_Type_create_struct(2, lengths, displs, types, large);
+    MPI_Type_commit(large);
+    MPI_Type_free(&chunk);
+    MPI_Type_free(&chunks);
+}
+
+/**
+ * @brief Exchange every segment between root and its process.
+ *
+ * Root gets a message per process, itself included, so that segments
+ * are addressed by pointer rather than by `int` displacement.
+ *
+ * @param buffer Whole buffer (significant on root only)
+ * @param counts Elements of every process
+ * @param displs Displacement of every process, in elements
+ * @param type Element datatype
+ * @param local Segment of this process
+ * @param root Rank owning whole buffer
+ * @param comm Communicator
+ * @param scatter 1 to send segments from root, 0 to send them to root
+ */
+static void exchange_segments(
+    void *buffer,
+    size_t *counts,
+    size_t *displs,
+    MPI_Datatype type,
+    void *local,
+    int root,
+    MPI_Comm comm,
+    int scatter
+) {
+    MPI_Datatype *types;
+    MPI_Request *requests;
+    MPI_Aint lb;
+    MPI_Aint extent;
+    int nproc;
+    int me;
+    int count = 0;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    MPI_Type_get_extent(type, &lb, &extent);
+    types = malloc((nproc + 1) * sizeof *types);
+    requests = malloc((nproc + 1) * sizeof *requests);
+
+    // own segment first, root matches its own message
+    large_type(counts[me], type, &types[nproc]);
+    if (scatter) {
+        MPI_Irecv(local, 1, types[nproc], root, TAG, comm, &requests[count++]);
+    } else {
+        MPI_Isend(local, 1, types[nproc], root, TAG, comm, &requests[count++]);
+    }
+    if (me == root) {
+        for (int p = 0; p < nproc; p++) {
+            char *segment = (char *) buffer + (MPI_Aint) displs[p] * extent;
+
+            large_type(counts[p], type, &types[p]);
+            if (scatter) {
+                MPI_Isend(segment, 1, types[p], p, TAG, comm, &requests[count++]);
+            } else {
+                MPI_Irecv(segment, 1, types[p], p, TAG, comm, &requests[count++]);
+            }
+        }
+    }
+    MPI_Waitall(count, requests, MPI_STATUSES_IGNORE);
+
+    MPI_Type_free(&types[nproc]);
+    if (me == root) {
+        for (int p = 0; p < nproc; p++) {
+            MPI_Type_free(&types[p]);
+        }
+    }
+    free(types);
+    free(requests);
+}
+#endif
+
+/**
+ * @brief Scatter segments of any size from root.
+ *
+ * Behaves as `MPI_Scatterv` as long as every count and displacement
+ * fits an `int`; past that, MPI-4 large count calls are used where
+ * available, point-to-point messages of chunked datatypes otherwise.
+ * Collective over the communicator.
+ *
+ * @param sendbuf Whole buffer (significant on root only)
+ * @param counts Elements of every process (significant on every process)
+ * @param displs Displacement of every process, in elements (idem)
+ * @param type Element datatype
+ * @param recvbuf Segment of this process
+ * @param root Rank owning whole buffer
+ * @param comm Communicator
+ */
+void scatterv_large(
+    void *sendbuf,
+    size_t *counts,
+    size_t *displs,
+    MPI_Datatype type,
+    void *recvbuf,
+    int root,
+    MPI_Comm comm
+) {
+    int nproc;
+    int me;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    if (fits_int(counts, displs, nproc)) {
+        int *int_counts = malloc(nproc * sizeof *int_counts);
+        int *int_displs = malloc(nproc * sizeof *int_displs);
+
+        for (int p = 0; p < nproc; p++) {
+            int_counts[p] = (int) counts[p];
+            int_displs[p] = (int) displs[p];
+        }
+        MPI_Scatterv(
+            sendbuf, int_counts, int_displs, type,
+            recvbuf, int_counts[me], type,
+            root, comm
+        );
+        free(int_counts);
+        free(int_displs);
+        return;
+    }
+
+#if MPI_VERSION >= 4
+    MPI_Count *large_counts = malloc(nproc * sizeof *large_counts);
+    MPI_Aint *large_displs = malloc(nproc * sizeof *large_displs);
+
+    for (int p = 0; p < nproc; p++) {
+        large_counts[p] = (MPI_Count) counts[p];
+        large_displs[p] = (MPI_Aint) displs[p];
+    }
+    MPI_Scatterv_c(
+        sendbuf, large_counts, large_displs, type,
+        recvbuf, large_counts[me], type,
+        root, comm
+    );
+    free(large_counts);
+    free(large_displs);
+#else
+    exchange_segments(sendbuf, counts, displs, type, recvbuf, root, comm, 1);
+#endif
+}
+
+/**
+ * @brief Gather segments of any size on root.
+ *
+ * Counterpart of `scatterv_large`. Collective over the communicator.
+ *
+ * @param sendbuf Segment of this process
+ * @param recvbuf Whole buffer (significant on root only)
+ * @param counts Elements of every process (significant on every process)
+ * @param displs Displacement of every process, in elements (idem)
+ * @param type Element datatype
+ * @param root Rank owning whole buffer
+ * @param comm Communicator
+ */
+void gatherv_large(
+    void *sendbuf,
+    void *recvbuf,
+    size_t *counts,
+    size_t *displs,
+    MPI_Datatype type,
+    int root,
+    MPI_Comm comm
+) {
+    int nproc;
+    int me;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    if (fits_int(counts, displs, nproc)) {
+        int *int_counts = malloc(nproc * sizeof *int_counts);
+        int *int_displs = malloc(nproc * sizeof *int_displs);
+
+        for (int p = 0; p < nproc; p++) {
+            int_counts[p] = (int) counts[p];
+            int_displs[p] = (int) displs[p];
+        }
+        MPI_Gatherv(
+            sendbuf, int_counts[me], type,
+            recvbuf, int_counts, int_displs, type,
+            root, comm
+        );
+        free(int_counts);
+        free(int_displs);
+        return;
+    }
+
+#if MPI_VERSION >= 4
+    MPI_Count *large_counts = malloc(nproc * sizeof *large_counts);
+    MPI_Aint *large_displs = malloc(nproc * sizeof *large_displs);
+
+    for (int p = 0; p < nproc; p++) {
+        large_counts[p] = (MPI_Count) counts[p];
+        large_displs[p] = (MPI_Aint) displs[p];
+    }
+    MPI_Gatherv_c(
+        sendbuf, large_counts[me], type,
+        recvbuf, large_counts, large_displs, type,
+        root, comm
+    );
+    free(large_counts);
+    free(large_displs);
+#else
+    exchange_segments(recvbuf, counts, displs, type, sendbuf, root, comm, 0);
+#endif
+}
@@ -9,12 +9,45 @@
  * @copyright Copyright (c) 2020
  * 
  */
+#define _XOPEN_SOURCE 700 /**< Use sysconf definition from POSIX */
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "matrixutils.h"
 
+/**
+ * @brief Side of transpose blocks small enough to stay in L1 cache.
+ */
+static const int TRANSPOSE_LEAF = 16;
+/**
+ * @brief Rows, or vectors, sharing every load in products.
+ */
+#define MATVEC_BLOCK 4
+/**
+ * @brief Matrix elements below which products are not worth threads.
+ */
+static const long MATVEC_MIN_ELEMENTS = 1L << 18;
+/**
+ * @brief Maximum number of threads of products.
+ */
+#define MATVEC_MAX_THREADS 64
+
+/**
+ * @brief Rows of a matrix product assigned to a thread.
+ */
+struct matvec_band {
+    double *result; /**< Result vectors */
+    double *a;      /**< Matrix */
+    int first;      /**< First row of band */
+    int last;       /**< Row after last one of band */
+    int cols;       /**< Matrix columns */
+    double *v;      /**< Vectors */
+    int count;      /**< Number of vectors */
+};
+
 /**
  * @brief Generate a matrix as array.
  * 
@@ -32,7 +65,7 @@ void generate_matrix_array(
 
     for (int i = 0; i < rows; i++) {
         for (int j = 0; j < columns; j++) {
-            v[i*rows + j] = min + (rand() / (RAND_MAX / (max - min)));
+            v[(size_t) i*columns + j] = min + (rand() / (RAND_MAX / (max - min)));
         }
     }
 }
@@ -40,7 +73,10 @@ void generate_matrix_array(
 /**
  * @brief Generate a dominant diagonal matrix as array.
  * 
- * Generate a dominant diagonal matrix as array.
+ * Generate a strictly dominant diagonal matrix as array: every diagonal
+ * element is twice the sum of other magnitudes in its row, plus the
+ * upper bound, so that Jacobi method at least halves error at every
+ * iteration.
  */
 void generate_dd_matrix_array(
     double *v,
@@ -50,29 +86,47 @@ void generate_dd_matrix_array(
     double max,
     int seed
 ) {
-    int pivot_index = 0;
-    int n = (rows + columns) / 2;
+    double sum;
     srand(seed);
 
-    for (int i = 0; i < rows*columns; i++) {
-        if (i == n*pivot_index + pivot_index) {
-            v[i] = pow(min + (rand() / (RAND_MAX / (max - min))), 2);
-            pivot_index++;
+    for (int i = 0; i < rows; i++) {
+        sum = 0.0;
+        for (int j = 0; j < columns; j++) {
+            v[(size_t) i*columns + j] = min + (rand() / (RAND_MAX / (max - min)));
+            if (j != i) {
+                sum += fabs(v[(size_t) i*columns + j]);
+            }
         }
-        else {
-            v[i] = min + (rand() / (RAND_MAX / (max - min)));
+        if (i < columns) {
+            v[(size_t) i*columns + i] = 2.0 * sum + max;
         }
     }
 }
 
+/**
+ * @brief Generate a dominant diagonal system Ax=b with known solution.
+ * 
+ * Generate a dominant diagonal matrix and known terms as product of
+ * matrix and a random solution, so that unknowns are of the order of
+ * generated values rather than of their ratio to the diagonal.
+ */
+void generate_dd_system(double *A, double *b, int n, double min, double max, int seed) {
+    double *x = malloc(n * sizeof *x);
+
+    generate_dd_matrix_array(A, n, n, min, max, seed);
+    generate_matrix_array(x, 1, n, min, max, seed + 1);
+    prod_mat_vett(b, A, n, n, x);
+    free(x);
+}
+
 /**
  * @brief Print an array matrix.
  * 
  * Print an array matrix.
  */
 void print_matrix_array(double *array, int rows, int columns) {
-    if (fmax((float) rows, (float) columns) > 50 || rows * columns > 100) {
-        printf("\tToo large to represent (%d elements)!\n", rows * columns);
+    if (fmax((float) rows, (float) columns) > 50 || (size_t) rows * columns > 100) {
+        printf("\tToo large to represent (%zu elements)!\n", (size_t) rows * columns);
         return;
     }
 
@@ -91,8 +145,201 @@ void print_matrix_array(double *array, int rows, int columns) {
  */
 void copy_matrix_array(double *array, double *copy, int rows, int columns) {
     for (int i = 0; i < rows; i++) {
+        size_t row = (size_t) i * columns;
+
         for (int j = 0; j < columns; j++) {
-            copy[i * columns + j] = array[i * columns + j];
+            copy[row + j] = array[row + j];
+        }
+    }
+}
+
+/**
+ * @brief Product of a band of matrix rows with a vector.
+ *
+ * Every vector element is loaded once for `MATVEC_BLOCK` rows, whose
+ * sums stay in registers; each sum still runs over columns in order,
+ * so results are the same as a plain dot product loop.
+ *
+ * @param arg Band of rows
+ * @return void* Always NULL
+ */
+static void *matvec_band_run(void *arg) {
+    struct matvec_band *b = arg;
+    int cols = b->cols;
+    int i = b->first;
+
+    for (; i + MATVEC_BLOCK <= b->last; i += MATVEC_BLOCK) {
+        double sum[MATVEC_BLOCK] = {0.0};
+        double *row = &b->a[(size_t) i * cols];
+
+        for (int j = 0; j < cols; j++) {
+            for (int k = 0; k < MATVEC_BLOCK; k++) {
+                sum[k] += row[(size_t) k * cols + j] * b->v[j];
+            }
+        }
+        for (int k = 0; k < MATVEC_BLOCK; k++) {
+            b->result[i + k] = sum[k];
+        }
+    }
+    // remaining rows of band
+    for (; i < b->last; i++) {
+        double sum = 0.0;
+
+        for (int j = 0; j < cols; j++) {
+            sum += b->a[(size_t) i * cols + j] * b->v[j];
+        }
+        b->result[i] = sum;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Product of a row of a matrix with several vectors.
+ *
+ * @param b Band the row belongs to
+ * @param i Row
+ * @param t First vector
+ */
+static void multi_matvec_row(struct matvec_band *b, int i, int t) {
+    int cols = b->cols;
+    int count = b->count;
+    double *row = &b->a[(size_t) i * cols];
+
+    for (; t < count; t++) {
+        double sum = 0.0;
+
+        for (int j = 0; j < cols; j++) {
+            sum += row[j] * b->v[(size_t) j * count + t];
+        }
+        b->result[(size_t) i * count + t] = sum;
+    }
+}
+
+/**
+ * @brief Product of a band of matrix rows with several vectors.
+ *
+ * Blocks of `MATVEC_BLOCK` rows and as many vectors keep their sums in
+ * registers, so that every matrix element is loaded once for all of
+ * the vectors in a block, every vector element once for all of the
+ * rows, and independent sums hide floating point latency.
+ *
+ * @param arg Band of rows
+ * @return void* Always NULL
+ */
+static void *multi_matvec_band_run(void *arg) {
+    struct matvec_band *b = arg;
+    int cols = b->cols;
+    int count = b->count;
+    int i = b->first;
+    int t;
+
+    for (; i + MATVEC_BLOCK <= b->last; i += MATVEC_BLOCK) {
+        double *row = &b->a[(size_t) i * cols];
+
+        for (t = 0; t + MATVEC_BLOCK <= count; t += MATVEC_BLOCK) {
+            double sum[MATVEC_BLOCK][MATVEC_BLOCK] = {{0.0}};
+
+            for (int j = 0; j < cols; j++) {
+                double *x = &b->v[(size_t) j * count + t];
+
+                for (int r = 0; r < MATVEC_BLOCK; r++) {
+                    for (int k = 0; k < MATVEC_BLOCK; k++) {
+                        sum[r][k] += row[(size_t) r * cols + j] * x[k];
+                    }
+                }
+            }
+            for (int r = 0; r < MATVEC_BLOCK; r++) {
+                for (int k = 0; k < MATVEC_BLOCK; k++) {
+                    b->result[(size_t) (i + r) * count + t + k] = sum[r][k];
+                }
+            }
+        }
+        // remaining vectors
+        for (int r = 0; r < MATVEC_BLOCK; r++) {
+            multi_matvec_row(b, i + r, t);
+        }
+    }
+    // remaining rows of band
+    for (; i < b->last; i++) {
+        multi_matvec_row(b, i, 0);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Number of threads sharing a matrix product.
+ *
+ * Large matrices get a band of rows for every online processor, so
+ * that memory bandwidth of the whole socket is used; small ones are
+ * left to the calling thread.
+ *
+ * @param rows Matrix rows
+ * @param cols Matrix columns
+ * @return int Number of threads, calling one included
+ */
+int matvec_threads(int rows, int cols) {
+    long threads_count = 1;
+
+    if ((long) rows * cols >= MATVEC_MIN_ELEMENTS) {
+        threads_count = sysconf(_SC_NPROCESSORS_ONLN);
+        threads_count = (threads_count < 1)? 1: threads_count;
+        threads_count = (threads_count > MATVEC_MAX_THREADS)? MATVEC_MAX_THREADS: threads_count;
+        threads_count = (threads_count > rows / MATVEC_BLOCK)? rows / MATVEC_BLOCK: threads_count;
+        threads_count = (threads_count < 1)? 1: threads_count;
+    }
+
+    return (int) threads_count;
+}
+
+/**
+ * @brief Split matrix rows among threads and run a product over them.
+ *
+ * Rows are split in as many bands as `matvec_threads` gives.
+ *
+ * @param run Product of a band
+ * @param result Result vectors
+ * @param a Matrix
+ * @param rows Matrix rows
+ * @param cols Matrix columns
+ * @param v Vectors
+ * @param count Number of vectors
+ */
+static void matvec_run(
+    void *(*run)(void *),
+    double *result,
+    double *a,
+    int rows,
+    int cols,
+    double *v,
+    int count
+) {
+    struct matvec_band bands[MATVEC_MAX_THREADS];
+    pthread_t threads[MATVEC_MAX_THREADS];
+    int started[MATVEC_MAX_THREADS];
+    int threads_count = matvec_threads(rows, cols);
+
+    for (int t = 0; t < threads_count; t++) {
+        bands[t].result = result;
+        bands[t].a = a;
+        bands[t].first = (int) ((long) rows * t / threads_count);
+        bands[t].last = (int) ((long) rows * (t + 1) / threads_count);
+        bands[t].cols = cols;
+        bands[t].v = v;
+        bands[t].count = count;
+    }
+    // calling thread takes first band, and any band
+    // whose thread could not start
+    for (int t = 1; t < threads_count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, run, &bands[t]) == 0;
+    }
+    run(&bands[0]);
+    for (int t = 1; t < threads_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        } else {
+            run(&bands[t]);
         }
     }
 }
@@ -100,21 +347,77 @@ void copy_matrix_array(double *array, double *copy, int rows, int columns) {
 /**
  * @brief Array matrix-vector dot product.
  * 
- * Array matrix-vector dot product.
+ * Array matrix-vector dot product, register blocked over rows and
+ * multithreaded over bands of rows for large matrices.
  */
 void prod_mat_vett(double result[], double *a, int rows, int cols, double v[]) {
-    for (int i = 0; i < rows; i++) {
-        result[i] = 0;
-        for (int j = 0; j < cols; j++) {
-            result[i] += a[i*cols+j] * v[j];
+    matvec_run(matvec_band_run, result, a, rows, cols, v, 1);
+}
+
+/**
+ * @brief Array matrix product with several vectors at once.
+ * 
+ * Array matrix product with several vectors at once: vectors and
+ * results are interleaved, i.e. element `j` of vector `t` is
+ * `v[j*count + t]`, so that every matrix element is read once for all
+ * of them.
+ *
+ * @param result Result vectors, `rows` elements each
+ * @param a Matrix
+ * @param rows Matrix rows
+ * @param cols Matrix columns
+ * @param v Vectors, `cols` elements each
+ * @param count Number of vectors
+ */
+void prod_mat_multi_vett(double *result, double *a, int rows, int cols, double *v, int count) {
+    matvec_run(multi_matvec_band_run, result, a, rows, cols, v, count);
+}
+
+/**
+ * @brief Transpose a block of an array matrix, recursively.
+ *
+ * The longer side is halved until blocks fit in L1 cache, whatever its
+ * size, so that both source rows and destination rows get reused from
+ * cache; leaf loops are left to compiler vectorization.
+ *
+ * @param array Source matrix
+ * @param transpose Destination matrix
+ * @param rows Source matrix rows
+ * @param columns Source matrix columns
+ * @param i0 First row of block
+ * @param i1 Row after last one of block
+ * @param j0 First column of block
+ * @param j1 Column after last one of block
+ */
+static void transpose_block(
+    double *array,
+    double *transpose,
+    int rows,
+    int columns,
+    int i0,
+    int i1,
+    int j0,
+    int j1
+) {
+    if (i1 - i0 <= TRANSPOSE_LEAF && j1 - j0 <= TRANSPOSE_LEAF) {
+        for (int j = j0; j < j1; j++) {
+            for (int i = i0; i < i1; i++) {
+                transpose[(size_t) j * rows + i] = array[(size_t) i * columns + j];
+            }
         }
+    } else if (i1 - i0 >= j1 - j0) {
+        transpose_block(array, transpose, rows, columns, i0, (i0 + i1) / 2, j0, j1);
+        transpose_block(array, transpose, rows, columns, (i0 + i1) / 2, i1, j0, j1);
+    } else {
+        transpose_block(array, transpose, rows, columns, i0, i1, j0, (j0 + j1) / 2);
+        transpose_block(array, transpose, rows, columns, i0, i1, (j0 + j1) / 2, j1);
     }
 }
 
 /**
  * @brief Transpose an array matrix.
  * 
- * Transpose an array matrix.
+ * Transpose an array matrix, cache-obliviously and in full precision.
  */
 void transpose_matrix_array(
     double *array,
@@ -122,15 +425,5 @@ void transpose_matrix_array(
     int rows,
     int columns
 ) {
-    int source_position, destination_position;
-    float source;
-
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < columns; ++j) {
-            source_position = columns * i + j;
-            destination_position = rows * j + i;
-            source = *(array + source_position);
-            *(transpose + destination_position) = source;
-        }
-    }
+    transpose_block(array, transpose, rows, columns, 0, rows, 0, columns);
 }
@@ -20,13 +20,13 @@
  * 
  * Default master (processor 0) in MPI cluster.
  */
-extern int MASTER;
+extern const int MASTER;
 /**
  * @brief Default tag for MPI 1-to-1 communications.
  * 
  * Default tag for MPI 1-to-1 communications.
  */
-extern int TAG;
+extern const int TAG;
 
 // void MPI_Pause(int process, int master, MPI_Comm comm) {
 //     if (process == master) {
@@ -0,0 +1,226 @@
+/**
+ * @file options.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Command-line options parsing.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _XOPEN_SOURCE 700 /**< Use getopt definition from POSIX */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "options.h"
+#include "outofcore.h"
+#include "regress.h"
+#include "snapshot.h"
+
+/**
+ * @brief Parse a comma-separated list of matrix orders.
+ *
+ * @param list Comma-separated list, e.g. `512,1024,2048`
+ * @param opts Options to store matrix orders into
+ * @return int 0 on success, -1 if an order is not a positive number
+ */
+static int parse_sizes(char *list, struct options *opts) {
+    char *next = list;
+
+    opts->size_count = 1;
+    for (char *c = list; *c != '\0'; c++) {
+        if (*c == ',') {
+            opts->size_count++;
+        }
+    }
+
+    opts->sizes = malloc(opts->size_count * sizeof *opts->sizes);
+    for (int i = 0; i < opts->size_count; i++) {
+        opts->sizes[i] = (int) strtol(next, &next, 10);
+        // every order ends at a comma or at the end of the list
+        if (opts->sizes[i] <= 0 || (*next != ',' && *next != '\0')) {
+            free(opts->sizes);
+            opts->sizes = NULL;
+            opts->size_count = 0;
+            return -1;
+        }
+        next++;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Parse command-line options and positional parameters.
+ *
+ * Options come first, then `<matrixOrders> <outputFileName> [<debugFlag>]`
+ * where matrix orders are a comma-separated list.
+ *
+ * @param argc Count of command-line parameters
+ * @param argv Command-line parameters
+ * @param optstring Options accepted by the calling binary, `getopt` style
+ * @param opts Parsed options
+ * @return int 0 on success, -1 on invalid or insufficient parameters
+ */
+int parse_options(
+    int argc,
+    char **argv,
+    const char *optstring,
+    struct options *opts
+) {
+    int opt;
+
+    memset(opts, 0, sizeof *opts);
+    opts->repetitions = 1;
+    opts->band = NOISE_BAND;
+    opts->fused = FUSED_ITERATIONS;
+    opts->snapshot_every = SNAPSHOT_EVERY;
+    opts->snapshot_stride = 1;
+    opts->group_size = 1;
+    while ((opt = getopt(argc, argv, optstring)) != -1) {
+        switch (opt) {
+            case 'c':
+                opts->counters = 1;
+                break;
+            case 'r':
+                opts->repetitions = atoi(optarg);
+                break;
+            case 'w':
+                opts->warmup = atoi(optarg);
+                break;
+            case 'V':
+                opts->verify = 1;
+                break;
+            case 'b':
+                free(opts->baseline_file);
+                opts->baseline_file = malloc(strlen(optarg) + 1);
+                sprintf(opts->baseline_file, "%s", optarg);
+                break;
+            case 'e':
+                opts->band = atof(optarg);
+                break;
+            case 'x':
+                free(opts->halo);
+                opts->halo = malloc(strlen(optarg) + 1);
+                sprintf(opts->halo, "%s", optarg);
+                break;
+            case 'o':
+                free(opts->grid_file);
+                opts->grid_file = malloc(strlen(optarg) + 1);
+                sprintf(opts->grid_file, "%s", optarg);
+                break;
+            case 'f':
+                opts->fused = atoi(optarg);
+                break;
+            case 'z':
+                free(opts->compress);
+                opts->compress = malloc(strlen(optarg) + 1);
+                sprintf(opts->compress, "%s", optarg);
+                break;
+            case 'S':
+                free(opts->snapshot_prefix);
+                opts->snapshot_prefix = malloc(strlen(optarg) + 1);
+                sprintf(opts->snapshot_prefix, "%s", optarg);
+                break;
+            case 'k':
+                opts->snapshot_every = atoi(optarg);
+                break;
+            case 's':
+                opts->snapshot_stride = atoi(optarg);
+                break;
+            case 'A':
+                opts->autotune = 1;
+                break;
+            case 'T':
+                free(opts->tune_file);
+                opts->tune_file = malloc(strlen(optarg) + 1);
+                sprintf(opts->tune_file, "%s", optarg);
+                break;
+            case 'm':
+                free(opts->mode);
+                opts->mode = malloc(strlen(optarg) + 1);
+                sprintf(opts->mode, "%s", optarg);
+                break;
+            case 't':
+                opts->threads = atoi(optarg);
+                break;
+            case 'P':
+                opts->placement = 1;
+                break;
+            case 'M':
+                free(opts->matrix_file);
+                opts->matrix_file = malloc(strlen(optarg) + 1);
+                sprintf(opts->matrix_file, "%s", optarg);
+                break;
+            case 'F':
+                free(opts->job_file);
+                opts->job_file = malloc(strlen(optarg) + 1);
+                sprintf(opts->job_file, "%s", optarg);
+                break;
+            case 'g':
+                opts->group_size = atoi(optarg);
+                break;
+            case 'a':
+                opts->autoranks = 1;
+                break;
+            case 'j':
+                free(opts->trace_file);
+                opts->trace_file = malloc(strlen(optarg) + 1);
+                sprintf(opts->trace_file, "%s", optarg);
+                break;
+            default:
+                return -1;
+        }
+    }
+
+    if (argc - optind < 2 || opts->repetitions < 1 || opts->warmup < 0 ||
+        opts->band < 0.0 || opts->fused < 1 || opts->snapshot_every < 1 ||
+        opts->snapshot_stride < 1 || opts->group_size < 1) {
+        return -1;
+    }
+    if (parse_sizes(argv[optind], opts) != 0) {
+        return -1;
+    }
+    opts->output_file = malloc(strlen(argv[optind + 1]) + 1);
+    sprintf(opts->output_file, "%s", argv[optind + 1]);
+    if (argc - optind > 2) {
+        opts->debug = (unsigned char) atoi(argv[optind + 2]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Free memory held by parsed options.
+ *
+ * @param opts Parsed options
+ */
+void free_options(struct options *opts) {
+    free(opts->sizes);
+    free(opts->output_file);
+    free(opts->baseline_file);
+    free(opts->halo);
+    free(opts->grid_file);
+    free(opts->compress);
+    free(opts->snapshot_prefix);
+    free(opts->tune_file);
+    free(opts->mode);
+    free(opts->matrix_file);
+    free(opts->trace_file);
+    free(opts->job_file);
+    opts->sizes = NULL;
+    opts->output_file = NULL;
+    opts->baseline_file = NULL;
+    opts->halo = NULL;
+    opts->grid_file = NULL;
+    opts->compress = NULL;
+    opts->snapshot_prefix = NULL;
+    opts->tune_file = NULL;
+    opts->mode = NULL;
+    opts->matrix_file = NULL;
+    opts->trace_file = NULL;
+    opts->job_file = NULL;
+}
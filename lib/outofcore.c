@@ -0,0 +1,417 @@
+/**
+ * @file outofcore.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Out-of-core Jacobi method over grids stored in files.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _XOPEN_SOURCE 700 /**< Use pread and pwrite definitions from POSIX */
+#define _FILE_OFFSET_BITS 64 /**< Use 64 bit file offsets */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "jacobi.h"
+#include "outofcore.h"
+
+/**
+ * @brief Band of grid rows read from file in background.
+ *
+ * Band of grid rows read from file in background.
+ */
+struct band_read {
+    int fd;          /**< Grid file */
+    double *buffer;  /**< Band rows */
+    size_t bytes;    /**< Band size */
+    off_t offset;    /**< Band position in file */
+    int failed;      /**< Whether read failed */
+    int started;     /**< Whether reading thread runs and is to be joined */
+    pthread_t thread; /**< Reading thread */
+};
+
+/**
+ * @brief Read exactly the given bytes at an offset of a file.
+ *
+ * @param fd File descriptor
+ * @param buffer Destination buffer
+ * @param bytes Bytes to read
+ * @param offset File offset
+ * @return int 0 on success, -1 on error or early end of file
+ */
+static int pread_full(int fd, void *buffer, size_t bytes, off_t offset) {
+    ssize_t done;
+
+    while (bytes > 0) {
+        done = pread(fd, buffer, bytes, offset);
+        if (done <= 0) {
+            return -1;
+        }
+        buffer = (char *) buffer + done;
+        bytes -= done;
+        offset += done;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Write exactly the given bytes at an offset of a file.
+ *
+ * @param fd File descriptor
+ * @param buffer Source buffer
+ * @param bytes Bytes to write
+ * @param offset File offset
+ * @return int 0 on success, -1 on error
+ */
+static int pwrite_full(int fd, void *buffer, size_t bytes, off_t offset) {
+    ssize_t done;
+
+    while (bytes > 0) {
+        done = pwrite(fd, buffer, bytes, offset);
+        if (done <= 0) {
+            return -1;
+        }
+        buffer = (char *) buffer + done;
+        bytes -= done;
+        offset += done;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Body of band reading thread.
+ *
+ * @param arg Band to read
+ * @return void* Always NULL
+ */
+static void *band_read_run(void *arg) {
+    struct band_read *band = arg;
+
+    band->failed = pread_full(band->fd, band->buffer, band->bytes, band->offset);
+
+    return NULL;
+}
+
+/**
+ * @brief Start reading a band of rows in background.
+ *
+ * @param band Band to read, with file, buffer, size and offset set
+ * @return int 0 on success, -1 if thread could not start
+ */
+static int band_read_start(struct band_read *band) {
+    band->failed = 0;
+    band->started = pthread_create(&band->thread, NULL, band_read_run, band) == 0;
+
+    return band->started? 0: -1;
+}
+
+/**
+ * @brief Wait for a band read in background.
+ *
+ * @param band Band being read
+ * @return int 0 on success, -1 if read failed or never started
+ */
+static int band_read_wait(struct band_read *band) {
+    if (!band->started) {
+        return -1;
+    }
+    pthread_join(band->thread, NULL);
+    band->started = 0;
+
+    return band->failed? -1: 0;
+}
+
+/**
+ * @brief Generate a random matrix straight into a file.
+ *
+ * Values are the same `generate_matrix_array` gives for the same seed,
+ * but the matrix is never held in memory as a whole.
+ *
+ * @param grid_file File to write matrix into, overwritten
+ * @param n Matrix order
+ * @param min Minimum value
+ * @param max Maximum value
+ * @param seed Seed for `rand()`
+ * @return int 0 on success, -1 on error
+ */
+int ooc_generate(char *grid_file, int n, double min, double max, int seed) {
+    long band_rows = BAND_BYTES / ((long) n * sizeof (double));
+    double *band;
+    int fd;
+    int status = 0;
+
+    fd = open(grid_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot create grid file %s\n", grid_file);
+        return -1;
+    }
+    band_rows = band_rows > 0? band_rows: 1;
+    band = malloc(band_rows * n * sizeof *band);
+
+    srand(seed);
+    for (long first = 0; first < n && status == 0; first += band_rows) {
+        long rows = (first + band_rows <= n)? band_rows: n - first;
+
+        for (long k = 0; k < rows * n; k++) {
+            band[k] = min + (rand() / (RAND_MAX / (max - min)));
+        }
+        status = pwrite_full(
+            fd, band, rows * n * sizeof *band,
+            (off_t) first * n * sizeof *band
+        );
+    }
+    if (status != 0) {
+        fprintf(stderr, "Cannot write grid file %s\n", grid_file);
+    }
+
+    free(band);
+    close(fd);
+
+    return status;
+}
+
+/**
+ * @brief Apply some Jacobi iterations in a single pass over a grid file.
+ *
+ * Rows stream through a rolling window of 3 rows for every iteration
+ * level: as soon as row `r` is read, row `r - t` of level `t` only needs
+ * rows `r - t - 1` to `r - t + 1` of level `t - 1`, which are all in the
+ * window. Bands of rows are read in background while the previous one
+ * is being processed; rows of last level are written in bands.
+ *
+ * @param src Grid file to read
+ * @param dst Grid file to write
+ * @param n Matrix order
+ * @param levels Iterations to apply
+ * @param residuals Squared error of every iteration, from index 1
+ * @param stats Figures to update
+ * @return int 0 on success, -1 on I/O error
+ */
+static int ooc_pass(
+    int src,
+    int dst,
+    int n,
+    int levels,
+    double *residuals,
+    struct ooc_stats *stats
+) {
+    size_t row_bytes = n * sizeof (double);
+    long band_rows = BAND_BYTES / (long) row_bytes;
+    double *window;
+    double *out;
+    long out_rows = 0;
+    long out_first = 0;
+    struct band_read bands[2];
+    int current = 0;
+    long band_first = 0;
+    long band_end = 0;
+    int status = 0;
+
+    band_rows = band_rows > 0? band_rows: 1;
+    window = malloc((levels + 1) * 3 * row_bytes);
+    out = malloc(band_rows * row_bytes);
+    for (int b = 0; b < 2; b++) {
+        bands[b].fd = src;
+        bands[b].started = 0;
+        bands[b].buffer = malloc(band_rows * row_bytes);
+    }
+    stats->window = ((levels + 1) * 3 + 3 * band_rows) * (double) row_bytes;
+    for (int t = 0; t <= levels; t++) {
+        residuals[t] = 0.0;
+    }
+
+    // read first band, prefetch second one
+    bands[0].offset = 0;
+    bands[0].bytes = ((band_rows < n)? band_rows: n) * row_bytes;
+    status |= band_read_start(&bands[0]) || band_read_wait(&bands[0]);
+    band_end = bands[0].bytes / row_bytes;
+    if (band_end < n) {
+        bands[1].offset = (off_t) band_end * row_bytes;
+        bands[1].bytes = ((band_end + band_rows <= n)? band_rows: n - band_end) * row_bytes;
+        status |= band_read_start(&bands[1]);
+    }
+
+    for (long r = 0; r < n + levels && status == 0; r++) {
+        // level 0 is the grid as read from file
+        if (r < n) {
+            if (r == band_end) {
+                // switch to prefetched band, prefetch next one
+                status |= band_read_wait(&bands[1 - current]);
+                current = 1 - current;
+                band_first = band_end;
+                band_end += bands[current].bytes / row_bytes;
+                if (band_end < n) {
+                    bands[1 - current].offset = (off_t) band_end * row_bytes;
+                    bands[1 - current].bytes = (
+                        (band_end + band_rows <= n)? band_rows: n - band_end
+                    ) * row_bytes;
+                    status |= band_read_start(&bands[1 - current]);
+                }
+            }
+            memcpy(
+                &window[(r % 3) * n],
+                &bands[current].buffer[(r - band_first) * n],
+                row_bytes
+            );
+        }
+
+        for (int t = 1; t <= levels; t++) {
+            long i = r - t;
+            double *above = &window[(3 * (t - 1) + (i + 2) % 3) * n];
+            double *middle = &window[(3 * (t - 1) + i % 3) * n];
+            double *below = &window[(3 * (t - 1) + (i + 1) % 3) * n];
+            double *row = &window[(3 * t + i % 3) * n];
+
+            if (i < 0 || i >= n) {
+                continue;
+            }
+            // border rows and columns never change
+            if (i == 0 || i == n - 1) {
+                memcpy(row, middle, row_bytes);
+                continue;
+            }
+            row[0] = middle[0];
+            for (int j = 1; j < n - 1; j++) {
+                row[j] = (below[j] + above[j] + middle[j+1] + middle[j-1])/4.0;
+                residuals[t] += (row[j] - middle[j]) * (row[j] - middle[j]);
+            }
+            row[n - 1] = middle[n - 1];
+        }
+
+        // last level rows are done
+        if (r - levels >= 0) {
+            memcpy(&out[out_rows * n], &window[(3 * levels + (r - levels) % 3) * n], row_bytes);
+            out_rows++;
+            if (out_rows == band_rows || r - levels == n - 1) {
+                status |= pwrite_full(
+                    dst, out, out_rows * row_bytes,
+                    (off_t) out_first * row_bytes
+                );
+                out_first += out_rows;
+                out_rows = 0;
+            }
+        }
+    }
+    // do not leave a prefetch behind on error, nor
+    // join one that never started
+    for (int b = 0; b < 2; b++) {
+        if (bands[b].started) {
+            band_read_wait(&bands[b]);
+        }
+    }
+
+    stats->passes++;
+    stats->bytes_read += (double) n * row_bytes;
+    stats->bytes_written += (double) n * row_bytes;
+    free(window);
+    free(out);
+    free(bands[0].buffer);
+    free(bands[1].buffer);
+
+    return status? -1: 0;
+}
+
+/**
+ * @brief Apply Jacobi method over a grid file until convergence.
+ *
+ * Every pass over the grid applies up to `fused` iterations, keeping
+ * the error of each of them; when convergence is reached halfway
+ * through a pass, that pass is redone with fewer iterations, so that
+ * the solution is the same as `jacobi` function would give. Passes
+ * ping-pong between solution file and a scratch file next to it.
+ *
+ * @param grid_file Grid file to solve, left untouched
+ * @param solution_file Solution file, overwritten
+ * @param n Matrix order
+ * @param fused Iterations fused in a pass
+ * @param eps Error of last iteration
+ * @param stats Figures of the solution
+ * @return int Number of iterations, -1 on I/O error
+ */
+int ooc_jacobi(
+    char *grid_file,
+    char *solution_file,
+    int n,
+    int fused,
+    double *eps,
+    struct ooc_stats *stats
+) {
+    char *scratch_file = malloc(strlen(solution_file) + strlen(".scratch") + 1);
+    double *residuals = malloc((fused + 1) * sizeof *residuals);
+    int grid;
+    int solution;
+    int scratch;
+    int src;
+    int dst;
+    int itr = 0;
+    int levels;
+    int stop = 0;
+    double diff = 0.0;
+
+    memset(stats, 0, sizeof *stats);
+    sprintf(scratch_file, "%s.scratch", solution_file);
+    grid = open(grid_file, O_RDONLY);
+    solution = open(solution_file, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    scratch = open(scratch_file, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (grid < 0 || solution < 0 || scratch < 0) {
+        fprintf(stderr, "Cannot open %s, %s or %s\n", grid_file, solution_file, scratch_file);
+        itr = -1;
+    }
+
+    src = grid;
+    dst = solution;
+    while (itr >= 0 && stop == 0) {
+        levels = (MAX_ITERATIONS - itr < fused)? MAX_ITERATIONS - itr: fused;
+        if (ooc_pass(src, dst, n, levels, residuals, stats) != 0) {
+            itr = -1;
+            break;
+        }
+
+        // look for convergence within pass
+        for (int t = 1; t <= levels && stop == 0; t++) {
+            diff = sqrt(residuals[t]);
+            if (!(diff > CONVERGENCE_THRESHOLD && itr + t < MAX_ITERATIONS)) {
+                stop = t;
+            }
+        }
+        if (stop != 0 && stop < levels) {
+            // redo from same source, stopping at convergence
+            stats->redone++;
+            if (ooc_pass(src, dst, n, stop, residuals, stats) != 0) {
+                itr = -1;
+                break;
+            }
+        }
+        itr += (stop != 0)? stop: levels;
+
+        // next pass reads what this one wrote
+        if (stop == 0) {
+            src = dst;
+            dst = (src == solution)? scratch: solution;
+        }
+    }
+    *eps = diff;
+
+    if (grid >= 0) close(grid);
+    if (solution >= 0) close(solution);
+    if (scratch >= 0) close(scratch);
+    // last pass may have written into scratch file
+    if (itr >= 0 && dst == scratch) {
+        rename(scratch_file, solution_file);
+    } else {
+        remove(scratch_file);
+    }
+    free(scratch_file);
+    free(residuals);
+
+    return itr;
+}
@@ -0,0 +1,392 @@
+/**
+ * @file perfcounters.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Hardware counters and roofline report.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _GNU_SOURCE /**< Use syscall definition from glibc */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "perfcounters.h"
+
+/**
+ * @brief Elements of every array in STREAM triad (32 MiB per array).
+ */
+#define STREAM_LENGTH (1 << 22)
+/**
+ * @brief Number of STREAM triad trials, the best one is kept.
+ */
+#define STREAM_TRIALS 5
+/**
+ * @brief Bytes moved by a cache line fill.
+ */
+#define CACHE_LINE 64
+
+/**
+ * @brief Floating point operations per updated cell for every kernel.
+ *
+ * Sweep adds four neighbours and scales them, residual subtracts,
+ * squares and accumulates, copy performs no operation.
+ */
+static const double FLOPS_PER_CELL[KERNEL_COUNT] = { 4.0, 3.0, 0.0 };
+/**
+ * @brief Minimum memory traffic per updated cell for every kernel.
+ *
+ * Sweep streams one matrix in and one out (plus write-allocate),
+ * residual streams two matrices in, copy streams one in and one out
+ * (plus write-allocate).
+ */
+static const double BYTES_PER_CELL[KERNEL_COUNT] = { 24.0, 16.0, 24.0 };
+/**
+ * @brief Kernel names as printed in roofline report.
+ */
+static const char *KERNEL_NAMES[KERNEL_COUNT] = { "sweep", "residual", "copy" };
+
+static int enabled = 0;
+static int fds[COUNTER_COUNT] = { -1, -1, -1 };
+static unsigned long long started[COUNTER_COUNT];
+static double started_at;
+static struct kernel_counters counters;
+
+/**
+ * @brief Monotonic time in seconds.
+ *
+ * @return double Seconds from an arbitrary point in time
+ */
+static double now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1E9;
+}
+
+#ifdef __linux__
+/**
+ * @brief Open a user-space-only counter for the calling process.
+ *
+ * @param type Perf event type
+ * @param config Perf event configuration
+ * @return int File descriptor of the counter, -1 if unavailable
+ */
+static int open_event(unsigned int type, unsigned long long config) {
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/**
+ * @brief Read current values of open counters.
+ *
+ * @param values Counter values
+ */
+static void read_events(unsigned long long *values) {
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        values[c] = 0;
+        if (fds[c] >= 0 &&
+            read(fds[c], &values[c], sizeof values[c]) != sizeof values[c]) {
+            values[c] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Enable kernel instrumentation and open hardware counters.
+ *
+ * Kernel timing is always enabled; hardware events are counted only
+ * where `perf_event_open` allows it (see `perf_event_paranoid`).
+ *
+ * @return int Number of hardware events that could be opened
+ */
+int counters_open(void) {
+    int opened = 0;
+
+    memset(&counters, 0, sizeof counters);
+#ifdef __linux__
+    fds[COUNTER_CYCLES] = open_event(
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES
+    );
+    fds[COUNTER_INSTRUCTIONS] = open_event(
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS
+    );
+    fds[COUNTER_LLC_MISSES] = open_event(
+        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES
+    );
+#endif
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        counters.available[c] = fds[c] >= 0;
+        opened += counters.available[c];
+    }
+    enabled = 1;
+
+    return opened;
+}
+
+/**
+ * @brief Disable kernel instrumentation and close hardware counters.
+ */
+void counters_close(void) {
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        if (fds[c] >= 0) {
+            close(fds[c]);
+            fds[c] = -1;
+        }
+    }
+    enabled = 0;
+}
+
+/**
+ * @brief Start counting for a kernel invocation.
+ *
+ * It does nothing unless instrumentation has been enabled.
+ */
+void counters_begin(void) {
+    if (!enabled) {
+        return;
+    }
+
+    read_events(started);
+    started_at = now();
+}
+
+/**
+ * @brief Stop counting and charge events to a kernel.
+ *
+ * It does nothing unless instrumentation has been enabled.
+ *
+ * @param kernel Kernel to charge
+ * @param cells Number of cells updated by the invocation
+ */
+void counters_end(enum kernel kernel, double cells) {
+    unsigned long long stopped[COUNTER_COUNT];
+    double stopped_at;
+
+    if (!enabled) {
+        return;
+    }
+
+    stopped_at = now();
+    read_events(stopped);
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        counters.value[kernel][c] += stopped[c] - started[c];
+    }
+    counters.seconds[kernel] += stopped_at - started_at;
+    counters.cells[kernel] += cells;
+    counters.calls[kernel]++;
+}
+
+/**
+ * @brief Counters accumulated so far by the calling process.
+ *
+ * @return struct kernel_counters* Accumulated counters
+ */
+struct kernel_counters *counters_get(void) {
+    return &counters;
+}
+
+/**
+ * @brief Band of STREAM triad arrays run by a thread.
+ */
+struct triad_band {
+    double *a;    /**< Destination array */
+    double *b;    /**< First source array */
+    double *c;    /**< Second source array */
+    long first;   /**< First element of band */
+    long last;    /**< Element after last one of band */
+    int init;     /**< Whether to initialize band rather than run triad */
+};
+
+/**
+ * @brief Body of a STREAM triad thread.
+ *
+ * @param arg Band
+ * @return void* Always NULL
+ */
+static void *triad_run(void *arg) {
+    struct triad_band *band = arg;
+
+    if (band->init) {
+        for (long i = band->first; i < band->last; i++) {
+            band->a[i] = 0.0;
+            band->b[i] = 1.0;
+            band->c[i] = 2.0;
+        }
+    } else {
+        for (long i = band->first; i < band->last; i++) {
+            band->a[i] = band->b[i] + 3.0 * band->c[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Run every band of STREAM triad arrays, a thread each.
+ *
+ * Calling thread takes first band, and any band whose thread could not
+ * start, as matrix products do.
+ *
+ * @param bands Bands
+ * @param threads Number of bands
+ * @param init Whether to initialize bands rather than run triad
+ */
+static void triad_bands(struct triad_band *bands, int threads, int init) {
+    pthread_t *workers = malloc(threads * sizeof *workers);
+    int *started = malloc(threads * sizeof *started);
+
+    for (int t = 0; t < threads; t++) {
+        bands[t].init = init;
+    }
+    for (int t = 1; t < threads; t++) {
+        started[t] = pthread_create(&workers[t], NULL, triad_run, &bands[t]) == 0;
+    }
+    triad_run(&bands[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        } else {
+            triad_run(&bands[t]);
+        }
+    }
+    free(workers);
+    free(started);
+}
+
+/**
+ * @brief Measure a STREAM-like triad bandwidth ceiling.
+ *
+ * Runs `a[i] = b[i] + s * c[i]` over arrays much larger than last level
+ * caches and keeps the best of few trials, counting 24 bytes per
+ * element as STREAM does. Arrays are split in a band per thread, and
+ * every thread initializes its own band, so that its pages are local
+ * to it; thread start is timed too, as it is in matrix products.
+ *
+ * @param threads Number of threads, calling one included
+ * @return double Bandwidth in bytes per second, 0 if out of memory
+ */
+double stream_triad_bandwidth(int threads) {
+    double *a = malloc(STREAM_LENGTH * sizeof *a);
+    double *b = malloc(STREAM_LENGTH * sizeof *b);
+    double *c = malloc(STREAM_LENGTH * sizeof *c);
+    struct triad_band *bands = malloc(threads * sizeof *bands);
+    double best = 0.0;
+    double start;
+    volatile double sink;
+
+    if (a == NULL || b == NULL || c == NULL || bands == NULL) {
+        free(a);
+        free(b);
+        free(c);
+        free(bands);
+        return 0.0;
+    }
+
+    for (int t = 0; t < threads; t++) {
+        bands[t].a = a;
+        bands[t].b = b;
+        bands[t].c = c;
+        bands[t].first = (long) STREAM_LENGTH * t / threads;
+        bands[t].last = (long) STREAM_LENGTH * (t + 1) / threads;
+    }
+    triad_bands(bands, threads, 1);
+    for (int t = 0; t < STREAM_TRIALS; t++) {
+        start = now();
+        triad_bands(bands, threads, 0);
+        start = now() - start;
+        if (start > 0 && 24.0 * STREAM_LENGTH / start > best) {
+            best = 24.0 * STREAM_LENGTH / start;
+        }
+    }
+    sink = a[STREAM_LENGTH - 1];
+    (void) sink;
+
+    free(a);
+    free(b);
+    free(c);
+    free(bands);
+
+    return best;
+}
+
+/**
+ * @brief Print achieved GFLOP/s and GB/s of every kernel against roofline.
+ *
+ * Model bandwidth counts minimum traffic per cell; measured bandwidth
+ * counts a cache line for every last level cache miss, when available.
+ *
+ * @param k Accumulated counters (possibly summed over processes)
+ * @param ceiling Memory bandwidth ceiling in bytes per second
+ */
+void counters_report(struct kernel_counters *k, double ceiling) {
+    printf("Memory bandwidth ceiling (STREAM triad): %.2f GB/s\n", ceiling / 1E9);
+    printf(
+        "%-9s %8s %10s %9s %9s %9s %6s %7s %7s\n",
+        "Kernel", "Calls", "Time (ms)", "GFLOP/s", "GB/s", "LLC GB/s",
+        "IPC", "Roof %", "AI"
+    );
+    for (int i = 0; i < KERNEL_COUNT; i++) {
+        double seconds = k->seconds[i] > 0? k->seconds[i]: 1E-12;
+        double gbs = BYTES_PER_CELL[i] * k->cells[i] / seconds / 1E9;
+
+        printf(
+            "%-9s %8llu %10.3f %9.3f %9.3f ",
+            KERNEL_NAMES[i],
+            k->calls[i],
+            k->seconds[i] * 1E3,
+            FLOPS_PER_CELL[i] * k->cells[i] / seconds / 1E9,
+            gbs
+        );
+        if (k->available[COUNTER_LLC_MISSES]) {
+            printf(
+                "%9.3f ",
+                k->value[i][COUNTER_LLC_MISSES] * (double) CACHE_LINE / seconds / 1E9
+            );
+        }
+        else {
+            printf("%9s ", "n/a");
+        }
+        if (k->available[COUNTER_CYCLES] &&
+            k->available[COUNTER_INSTRUCTIONS] &&
+            k->value[i][COUNTER_CYCLES] > 0) {
+            printf(
+                "%6.2f ",
+                k->value[i][COUNTER_INSTRUCTIONS] / (double) k->value[i][COUNTER_CYCLES]
+            );
+        }
+        else {
+            printf("%6s ", "n/a");
+        }
+        printf(
+            "%6.1f%% %7.3f\n",
+            ceiling > 0? gbs * 1E9 / ceiling * 100: 0.0,
+            FLOPS_PER_CELL[i] / BYTES_PER_CELL[i]
+        );
+    }
+    if (!k->available[COUNTER_CYCLES] &&
+        !k->available[COUNTER_INSTRUCTIONS] &&
+        !k->available[COUNTER_LLC_MISSES]) {
+        printf("Hardware counters unavailable, check perf_event_paranoid.\n");
+    }
+}
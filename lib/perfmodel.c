@@ -0,0 +1,319 @@
+/**
+ * @file perfmodel.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Cost model of parallel grid solution.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "jacobi.h"
+#include "mpiutils.h"
+#include "perfmodel.h"
+
+/**
+ * @brief Stages of a reduction over some processes.
+ *
+ * @param nproc Number of processes
+ * @return int Base 2 logarithm of processes, rounded up
+ */
+int perfmodel_stages(int nproc) {
+    int stages = 0;
+
+    while ((1 << stages) < nproc) {
+        stages++;
+    }
+
+    return stages;
+}
+
+/**
+ * @brief Time an iteration of a grid, with the kernels of a slab one.
+ *
+ * @return double Seconds per inner cell
+ */
+double perfmodel_cell_time(void) {
+    size_t size = (size_t) PERFMODEL_ORDER * PERFMODEL_ORDER;
+    double *grid = malloc(size * sizeof *grid);
+    double *prime = malloc(size * sizeof *prime);
+    double t_start;
+
+    for (size_t i = 0; i < size; i++) {
+        grid[i] = (double) (i % 7);
+    }
+    memcpy(prime, grid, size * sizeof *prime);
+
+    // first iteration is left out
+    t_start = 0.0;
+    for (int r = -1; r < PERFMODEL_ROUNDS; r++) {
+        if (r == 0) {
+            t_start = MPI_Wtime();
+        }
+        jacobi_iteration(grid, prime, PERFMODEL_ORDER, PERFMODEL_ORDER);
+        convergence_check_g(grid, prime, PERFMODEL_ORDER, PERFMODEL_ORDER);
+        replace_partial(
+            grid, prime, PERFMODEL_ORDER,
+            PERFMODEL_ORDER, (size_t) (PERFMODEL_ORDER - 2) * PERFMODEL_ORDER, MASTER
+        );
+    }
+    t_start = MPI_Wtime() - t_start;
+    free(grid);
+    free(prime);
+
+    return t_start / PERFMODEL_ROUNDS /
+        ((double) (PERFMODEL_ORDER - 2) * (PERFMODEL_ORDER - 2));
+}
+
+/**
+ * @brief Time round trips between MASTER and the process after it,
+ * slab neighbours of each other.
+ *
+ * Called by both of them only.
+ *
+ * @param comm Communicator
+ * @param count Doubles of every message
+ * @param buffer Message buffer, of `count` doubles at least
+ * @return double Seconds per round trip
+ */
+double perfmodel_round_trip(MPI_Comm comm, int count, double *buffer) {
+    int me;
+    int peer;
+    double t_start = 0.0;
+
+    MPI_Comm_rank(comm, &me);
+    peer = (me == MASTER)? MASTER + 1: MASTER;
+    // first round trip is left out
+    for (int r = -1; r < PERFMODEL_ROUNDS; r++) {
+        if (r == 0) {
+            t_start = MPI_Wtime();
+        }
+        if (me == MASTER) {
+            MPI_Send(buffer, count, MPI_DOUBLE, peer, TAG, comm);
+            MPI_Recv(buffer, count, MPI_DOUBLE, peer, TAG, comm, MPI_STATUS_IGNORE);
+        } else {
+            MPI_Recv(buffer, count, MPI_DOUBLE, peer, TAG, comm, MPI_STATUS_IGNORE);
+            MPI_Send(buffer, count, MPI_DOUBLE, peer, TAG, comm);
+        }
+    }
+
+    return (MPI_Wtime() - t_start) / PERFMODEL_ROUNDS;
+}
+
+/**
+ * @brief Time `MPI_Allreduce` of a single value.
+ *
+ * Collective over the communicator.
+ *
+ * @param comm Communicator
+ * @return double Seconds per reduction of slowest process
+ */
+double perfmodel_reduction(MPI_Comm comm) {
+    double value = 0.0;
+    double t_start = 0.0;
+    double elapsed;
+
+    // first reduction is left out
+    for (int r = -1; r < PERFMODEL_ROUNDS; r++) {
+        if (r == 0) {
+            MPI_Barrier(comm);
+            t_start = MPI_Wtime();
+        }
+        MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_SUM, comm);
+    }
+    elapsed = (MPI_Wtime() - t_start) / PERFMODEL_ROUNDS;
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    return elapsed;
+}
+
+/**
+ * @brief Fit message times to latency plus size over bandwidth.
+ *
+ * Least squares line through one-way message times; negative
+ * figures, as noise may give, are taken as zero.
+ *
+ * @param count Number of messages
+ * @param bytes Size of every message
+ * @param seconds One-way time of every message
+ * @param latency Seconds per message
+ * @param byte Seconds per byte
+ */
+void perfmodel_fit(int count, double *bytes, double *seconds, double *latency, double *byte) {
+    double mean_bytes = 0.0;
+    double mean_seconds = 0.0;
+    double covariance = 0.0;
+    double variance = 0.0;
+
+    for (int i = 0; i < count; i++) {
+        mean_bytes += bytes[i] / count;
+        mean_seconds += seconds[i] / count;
+    }
+    for (int i = 0; i < count; i++) {
+        covariance += (bytes[i] - mean_bytes) * (seconds[i] - mean_seconds);
+        variance += (bytes[i] - mean_bytes) * (bytes[i] - mean_bytes);
+    }
+    *byte = (variance > 0.0)? covariance / variance: 0.0;
+    if (*byte < 0.0) {
+        *byte = 0.0;
+    }
+    *latency = mean_seconds - *byte * mean_bytes;
+    if (*latency < 0.0) {
+        *latency = 0.0;
+    }
+}
+
+/**
+ * @brief Measure model figures on the processes of a communicator.
+ *
+ * Per-cell time is measured with MASTER sweeping alone and with every
+ * process sweeping at once, so that contention for memory and cores
+ * is accounted for; latency and bandwidth are fitted to round trips of
+ * given message sizes between MASTER and the process after it,
+ * reduction stages come from `MPI_Allreduce` of a single value.
+ * Collective over the communicator.
+ *
+ * @param m Model
+ * @param comm Communicator
+ * @param message_count Number of message sizes, 2 at least
+ * @param counts Doubles of every message, ascending
+ * @param seconds One-way time of every message (significant on MASTER
+ * only), NULL if not needed
+ */
+void perfmodel_calibrate(
+    struct perfmodel *m,
+    MPI_Comm comm,
+    int message_count,
+    int *counts,
+    double *seconds
+) {
+    int nproc;
+    int me;
+    double *buffer;
+    double *bytes;
+    double *one_way;
+    double elapsed;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    m->nproc = nproc;
+
+    // one process sweeping, then every one of them
+    m->cell = 0.0;
+    if (me == MASTER) {
+        m->cell = perfmodel_cell_time();
+    }
+    MPI_Barrier(comm);
+    elapsed = perfmodel_cell_time();
+    MPI_Allreduce(&elapsed, &m->cell_busy, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+    // a small message costs latency, a large one bandwidth too
+    m->latency = 0.0;
+    m->byte = 0.0;
+    if (nproc > 1 && me <= MASTER + 1) {
+        buffer = calloc(counts[message_count - 1], sizeof *buffer);
+        bytes = malloc(message_count * sizeof *bytes);
+        one_way = (seconds != NULL)? seconds: malloc(message_count * sizeof *one_way);
+        for (int i = 0; i < message_count; i++) {
+            bytes[i] = counts[i] * sizeof *buffer;
+            one_way[i] = perfmodel_round_trip(comm, counts[i], buffer) / 2;
+        }
+        perfmodel_fit(message_count, bytes, one_way, &m->latency, &m->byte);
+        if (seconds == NULL) {
+            free(one_way);
+        }
+        free(bytes);
+        free(buffer);
+    }
+
+    elapsed = perfmodel_reduction(comm);
+    m->stage = (nproc > 1)? elapsed / perfmodel_stages(nproc): 0.0;
+
+    MPI_Bcast(m, sizeof *m, MPI_BYTE, MASTER, comm);
+}
+
+/**
+ * @brief Predicted time of an iteration of a slab solution.
+ *
+ * Sweep, residual and copy of the largest slab, then a reduction and
+ * a barrier, then a ghost row sent to either neighbour. Per-cell time
+ * grows from the one of a single process to the one of every process
+ * calibrated as more of them sweep at once, and stays there past them.
+ *
+ * @param m Model
+ * @param n Matrix order
+ * @param nproc Number of processes solving
+ * @return double Seconds
+ */
+double perfmodel_iteration(struct perfmodel *m, int n, int nproc) {
+    double cell = m->cell;
+    double rows = (double) (n - 2) / nproc;
+    double seconds;
+
+    // past calibrated processes, more of them come with more nodes
+    if (m->nproc > 1) {
+        cell += (m->cell_busy - m->cell) *
+            ((nproc < m->nproc)? nproc - 1: m->nproc - 1) / (m->nproc - 1);
+    }
+    seconds = cell * rows * (n - 2);
+    if (nproc > 1) {
+        seconds += 2 * perfmodel_stages(nproc) * m->stage;
+        seconds += 2 * (m->latency + n * sizeof(double) * m->byte);
+    }
+
+    return seconds;
+}
+
+/**
+ * @brief Predicted time of a slab solution, as timed by jacobi-parallel.
+ *
+ * Iterations, then a gather of every slab on MASTER.
+ *
+ * @param m Model
+ * @param n Matrix order
+ * @param nproc Number of processes solving
+ * @param iterations Number of iterations
+ * @return double Seconds
+ */
+double perfmodel_solution(struct perfmodel *m, int n, int nproc, int iterations) {
+    double seconds = iterations * perfmodel_iteration(m, n, nproc);
+
+    if (nproc > 1) {
+        seconds += (nproc - 1) * m->latency;
+        seconds += (double) n * n * sizeof(double) * m->byte * (nproc - 1) / nproc;
+    }
+
+    return seconds;
+}
+
+/**
+ * @brief Number of processes a slab solution is predicted fastest over.
+ *
+ * Every process must get at least 2 rows.
+ *
+ * @param m Model
+ * @param n Matrix order
+ * @param nproc Number of processes available
+ * @param iterations Number of iterations
+ * @return int Number of processes, 1 to `nproc`
+ */
+int perfmodel_ranks(struct perfmodel *m, int n, int nproc, int iterations) {
+    int best = 1;
+    double best_time = perfmodel_solution(m, n, 1, iterations);
+    double time;
+
+    for (int p = 2; p <= nproc && n / p >= 2; p++) {
+        time = perfmodel_solution(m, n, p, iterations);
+        if (time < best_time) {
+            best = p;
+            best_time = time;
+        }
+    }
+
+    return best;
+}
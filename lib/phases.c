@@ -0,0 +1,264 @@
+/**
+ * @file phases.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Per-phase timing functions.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "phases.h"
+#include "mpiutils.h"
+
+/**
+ * @brief Phase names as written in CSV and JSON reports.
+ *
+ * Phase names as written in CSV and JSON reports.
+ */
+const char *PHASE_NAMES[PHASE_COUNT] = {
+    "startup",
+    "scatter",
+    "sweep",
+    "residual",
+    "allreduce",
+    "barrier",
+    "exchange",
+    "copy",
+    "snapshot",
+    "gather"
+};
+
+/**
+ * @brief Reset phase accumulators, with no trace attached.
+ *
+ * @param p Phase accumulators
+ */
+void phases_reset(struct phases *p) {
+    memset(p->elapsed, 0, sizeof p->elapsed);
+    p->mark = MPI_Wtime();
+    p->trace = NULL;
+}
+
+/**
+ * @brief Start a new lap without charging elapsed time to any phase.
+ *
+ * @param p Phase accumulators
+ */
+void phases_start(struct phases *p) {
+    p->mark = MPI_Wtime();
+}
+
+/**
+ * @brief Charge time elapsed since last lap to a phase.
+ *
+ * @param p Phase accumulators
+ * @param phase Phase to charge
+ */
+void phases_lap(struct phases *p, enum phase phase) {
+    double now = MPI_Wtime();
+
+    p->elapsed[phase] += now - p->mark;
+    if (p->trace != NULL) {
+        trace_record(p->trace, phase, p->mark, now);
+    }
+    p->mark = now;
+}
+
+/**
+ * @brief Discard solution phases accumulated so far, keeping startup.
+ *
+ * Used to leave warmup solutions out of the breakdown.
+ *
+ * @param p Phase accumulators
+ */
+void phases_discard(struct phases *p) {
+    double startup = p->elapsed[PHASE_STARTUP];
+
+    memset(p->elapsed, 0, sizeof p->elapsed);
+    p->elapsed[PHASE_STARTUP] = startup;
+}
+
+/**
+ * @brief Reduce phase accumulators of every rank into min/avg/max values.
+ *
+ * Solution phases are averaged over repetitions, startup is not.
+ * Collective over the communicator; only MASTER gets meaningful stats.
+ *
+ * @param p Local phase accumulators
+ * @param stats Reduced phase times (meaningful on MASTER only)
+ * @param n Matrix order
+ * @param repetitions Number of solutions accumulated
+ * @param comm Communicator
+ */
+void phases_reduce(
+    struct phases *p,
+    struct phase_stats *stats,
+    int n,
+    int repetitions,
+    MPI_Comm comm
+) {
+    int nproc;
+    double elapsed[PHASE_COUNT];
+
+    MPI_Comm_size(comm, &nproc);
+    stats->n = n;
+    stats->nproc = nproc;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        elapsed[i] = (i == PHASE_STARTUP || repetitions < 1)?
+            p->elapsed[i]:
+            p->elapsed[i] / repetitions;
+    }
+
+    MPI_Reduce(elapsed, stats->min, PHASE_COUNT, MPI_DOUBLE, MPI_MIN, MASTER, comm);
+    MPI_Reduce(elapsed, stats->max, PHASE_COUNT, MPI_DOUBLE, MPI_MAX, MASTER, comm);
+    MPI_Reduce(elapsed, stats->avg, PHASE_COUNT, MPI_DOUBLE, MPI_SUM, MASTER, comm);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        stats->avg[i] /= nproc;
+    }
+}
+
+/**
+ * @brief Load imbalance of a phase, as max/avg - 1.
+ *
+ * @param stats Reduced phase times
+ * @param phase Phase of interest
+ * @return double 0 for perfect balance, growing with the slowest rank
+ */
+double phases_imbalance(struct phase_stats *stats, enum phase phase) {
+    if (stats->avg[phase] <= 0.0) {
+        return 0.0;
+    }
+
+    return stats->max[phase] / stats->avg[phase] - 1.0;
+}
+
+/**
+ * @brief Print reduced phase times in a table.
+ *
+ * @param stats Reduced phase times
+ */
+void phases_print(struct phase_stats *stats) {
+    printf(
+        "%-10s %12s %12s %12s %10s\n",
+        "Phase", "Min (ms)", "Avg (ms)", "Max (ms)", "Imbalance"
+    );
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        printf(
+            "%-10s %12.3f %12.3f %12.3f %9.1f%%\n",
+            PHASE_NAMES[i],
+            stats->min[i] * 1E3,
+            stats->avg[i] * 1E3,
+            stats->max[i] * 1E3,
+            phases_imbalance(stats, i) * 100
+        );
+    }
+}
+
+/**
+ * @brief Build a report file name next to results file.
+ *
+ * `data/results.csv` becomes `data/results-phases.json` for `.json`
+ * extension.
+ *
+ * @param results_file Results file name
+ * @param extension Report file extension, dot included
+ * @return char* Allocated report file name
+ */
+static char *report_name(char *results_file, char *extension) {
+    size_t length = strlen(results_file);
+    char *name = malloc(length + strlen("-phases") + strlen(extension) + 1);
+
+    if (length > 4 && strcmp(results_file + length - 4, ".csv") == 0) {
+        length -= 4;
+    }
+    sprintf(name, "%.*s-phases%s", (int) length, results_file, extension);
+
+    return name;
+}
+
+/**
+ * @brief Write reduced phase times next to results file.
+ *
+ * CSV report is appended to (header is written for a new file), JSON
+ * report is rewritten with the records of the current execution.
+ *
+ * @param results_file Results file name
+ * @param stats Reduced phase times, one for every record
+ * @param count Number of records
+ * @return int 0 on success, -1 if a report could not be written
+ */
+int phases_write(char *results_file, struct phase_stats *stats, int count) {
+    char *csv_name = report_name(results_file, ".csv");
+    char *json_name = report_name(results_file, ".json");
+    FILE *csv;
+    FILE *json;
+    long position;
+
+    csv = fopen(csv_name, "a");
+    json = fopen(json_name, "w");
+    if (csv == NULL || json == NULL) {
+        fprintf(stderr, "Cannot write phase reports %s, %s\n", csv_name, json_name);
+        if (csv != NULL) fclose(csv);
+        if (json != NULL) fclose(json);
+        free(csv_name);
+        free(json_name);
+        return -1;
+    }
+
+    fseek(csv, 0, SEEK_END);
+    position = ftell(csv);
+    if (position == 0) {
+        fprintf(
+            csv,
+            "\"Size\",\"Processors\",\"Phase\",\"TimeMin\",\"TimeAvg\",\"TimeMax\",\"Imbalance\"\n"
+        );
+    }
+    fprintf(json, "[\n");
+    for (int r = 0; r < count; r++) {
+        fprintf(
+            json,
+            "  {\"size\": %d, \"processors\": %d, \"phases\": {\n",
+            stats[r].n,
+            stats[r].nproc
+        );
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            fprintf(
+                csv,
+                "%d,%d,\"%s\",%f,%f,%f,%f\n",
+                stats[r].n,
+                stats[r].nproc,
+                PHASE_NAMES[i],
+                stats[r].min[i],
+                stats[r].avg[i],
+                stats[r].max[i],
+                phases_imbalance(&stats[r], i)
+            );
+            fprintf(
+                json,
+                "    \"%s\": {\"min\": %f, \"avg\": %f, \"max\": %f, \"imbalance\": %f}%s\n",
+                PHASE_NAMES[i],
+                stats[r].min[i],
+                stats[r].avg[i],
+                stats[r].max[i],
+                phases_imbalance(&stats[r], i),
+                i < PHASE_COUNT - 1? ",": ""
+            );
+        }
+        fprintf(json, "  }}%s\n", r < count - 1? ",": "");
+    }
+    fprintf(json, "]\n");
+
+    fclose(csv);
+    fclose(json);
+    free(csv_name);
+    free(json_name);
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file placement.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Locality-aware rank placement.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _GNU_SOURCE /**< Use sched_getcpu definition from GNU */
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "placement.h"
+
+/**
+ * @brief Physical package of a CPU, as exposed by Linux sysfs.
+ *
+ * @param cpu CPU
+ * @return int Physical package, -1 if unknown
+ */
+static int cpu_socket(int cpu) {
+    char name[128];
+    FILE *file;
+    int socket = -1;
+
+    if (cpu < 0) {
+        return -1;
+    }
+    snprintf(name, sizeof name, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    file = fopen(name, "r");
+    if (file != NULL) {
+        if (fscanf(file, "%d", &socket) != 1) {
+            socket = -1;
+        }
+        fclose(file);
+    }
+
+    return socket;
+}
+
+/**
+ * @brief Discover where this process runs.
+ *
+ * Nodes come from a shared-memory split of the communicator. Unbound
+ * processes may migrate between CPUs afterwards, so socket and CPU are
+ * only meaningful when the launcher binds processes.
+ * Collective over the communicator.
+ *
+ * @param comm Communicator
+ * @param mine Locality of this process
+ */
+void placement_discover(MPI_Comm comm, struct locality *mine) {
+    MPI_Comm node;
+    int me;
+
+    MPI_Comm_rank(comm, &me);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, me, MPI_INFO_NULL, &node);
+    MPI_Allreduce(&me, &mine->node, 1, MPI_INT, MPI_MIN, node);
+    MPI_Comm_free(&node);
+    mine->cpu = sched_getcpu();
+    mine->socket = cpu_socket(mine->cpu);
+}
+
+/**
+ * @brief Count neighbour links of the rank chain by locality.
+ *
+ * Collective over the communicator, figures are given to every process.
+ *
+ * @param comm Communicator
+ * @param links Neighbour links by locality
+ */
+void placement_links(MPI_Comm comm, struct placement_links *links) {
+    int nproc;
+    struct locality mine;
+    struct locality *all;
+
+    MPI_Comm_size(comm, &nproc);
+    placement_discover(comm, &mine);
+    all = malloc(nproc * sizeof *all);
+    MPI_Allgather(&mine, 3, MPI_INT, all, 3, MPI_INT, comm);
+
+    links->nodes = 0;
+    links->links = nproc - 1;
+    links->on_node = 0;
+    links->on_socket = 0;
+    for (int p = 0; p < nproc; p++) {
+        // a node is counted by its lowest rank
+        links->nodes += all[p].node == p;
+        if (p + 1 < nproc && all[p].node == all[p + 1].node) {
+            links->on_node++;
+            links->on_socket += all[p].socket >= 0 && all[p].socket == all[p + 1].socket;
+        }
+    }
+    free(all);
+}
+
+/**
+ * @brief Compare localities, node first, then socket, CPU and rank.
+ *
+ * @param a A locality, followed by its rank
+ * @param b Another locality, followed by its rank
+ * @return int Negative, zero or positive as `qsort` wants
+ */
+static int locality_compare(const void *a, const void *b) {
+    const int *la = a;
+    const int *lb = b;
+
+    for (int f = 0; f < 4; f++) {
+        if (la[f] != lb[f]) {
+            return (la[f] > lb[f]) - (la[f] < lb[f]);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Rank processes anew so that chain neighbours are co-located.
+ *
+ * Processes are sorted by node, socket and CPU, ties broken by rank,
+ * so that ranks of a node, and of a socket within it, are contiguous
+ * and every slab boundary but one per node stays within a node.
+ * Collective over the communicator.
+ *
+ * @param comm Communicator
+ * @param placed Communicator ranked by locality
+ */
+void placement_reorder(MPI_Comm comm, MPI_Comm *placed) {
+    int nproc;
+    int me;
+    int key = 0;
+    struct locality locality;
+    int mine[4];
+    int *all;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    placement_discover(comm, &locality);
+    mine[0] = locality.node;
+    mine[1] = locality.socket;
+    mine[2] = locality.cpu;
+    mine[3] = me;
+    all = malloc(4 * nproc * sizeof *all);
+    MPI_Allgather(mine, 4, MPI_INT, all, 4, MPI_INT, comm);
+
+    // new rank is the number of processes sorting before this one
+    for (int p = 0; p < nproc; p++) {
+        key += locality_compare(&all[4 * p], mine) < 0;
+    }
+    MPI_Comm_split(comm, 0, key, placed);
+    free(all);
+}
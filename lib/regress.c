@@ -0,0 +1,193 @@
+/**
+ * @file regress.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Correctness and performance regression checks.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "regress.h"
+#include "stats.h"
+
+/**
+ * @brief Look up median time of a configuration in a results file.
+ *
+ * Results files have a header line; serial records are
+ * `<size>,<median>,<min>,<max>`, parallel and multithreaded ones
+ * `<processors>,<median>,<min>,<max>,<size>`, with threads as
+ * processors. The last record of given configuration wins.
+ *
+ * @param baseline_file Baseline results file name
+ * @param size Matrix order
+ * @param processors Number of processors or threads, 0 for serial results
+ * @param median Baseline median time
+ * @return int 0 on success, -1 if file or record is missing
+ */
+int baseline_median(char *baseline_file, int size, int processors, double *median) {
+    FILE *baseline = fopen(baseline_file, "r");
+    char line[256];
+    int record_key;
+    int record_size;
+    double record_median;
+    int found = -1;
+
+    if (baseline == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof line, baseline) != NULL) {
+        // header and malformed lines do not scan, nor do parallel
+        // records with no size
+        if (processors == 0) {
+            if (sscanf(line, "%d,%lf", &record_key, &record_median) == 2 &&
+                record_key == size) {
+                *median = record_median;
+                found = 0;
+            }
+        } else if (sscanf(
+                line, "%d,%lf,%*f,%*f,%d", &record_key, &record_median, &record_size
+            ) == 3 &&
+            record_key == processors && record_size == size) {
+            *median = record_median;
+            found = 0;
+        }
+    }
+    fclose(baseline);
+
+    return found;
+}
+
+/**
+ * @brief One-sided binomial sign test.
+ *
+ * Probability of at least `exceeding` out of `count` samples landing
+ * above a threshold when, with no regression, each one does with
+ * probability 1/2 at most.
+ *
+ * @param exceeding Samples above threshold
+ * @param count Number of samples
+ * @return double p-value
+ */
+double sign_test(int exceeding, int count) {
+    double p_value = 0.0;
+    double binomial = 1.0; // count choose k
+
+    for (int k = 0; k <= count; k++) {
+        if (k > 0) {
+            binomial = binomial * (count - k + 1) / k;
+        }
+        if (k >= exceeding) {
+            p_value += binomial;
+        }
+    }
+
+    return p_value / pow(2.0, count);
+}
+
+/**
+ * @brief Check timing samples against a baseline median.
+ *
+ * Current build regressed if its samples are significantly slower than
+ * baseline median inflated by the noise band; a single slow sample
+ * never fails the check, a consistently slow run does.
+ *
+ * @param samples Time samples of current build
+ * @param count Number of samples
+ * @param baseline Baseline median time
+ * @param band Relative noise band (e.g. 0.05 for 5%)
+ * @param r Check outcome
+ */
+void check_regression(
+    double *samples,
+    int count,
+    double baseline,
+    double band,
+    struct regression *r
+) {
+    struct time_stats stats;
+
+    summarize_times(samples, count, &stats);
+    r->baseline = baseline;
+    r->threshold = baseline * (1.0 + band);
+    r->median = stats.median;
+    r->samples = count;
+    r->exceeding = 0;
+    for (int i = 0; i < count; i++) {
+        if (samples[i] > r->threshold) {
+            r->exceeding++;
+        }
+    }
+    r->p_value = sign_test(r->exceeding, count);
+    r->regressed = r->p_value < SIGNIFICANCE;
+}
+
+/**
+ * @brief Print outcome of a regression check.
+ *
+ * GFLOP/s are given for the same amount of work, so that they regress
+ * exactly as much as time does.
+ *
+ * @param label Checked configuration
+ * @param r Check outcome
+ * @param flops Floating point operations of a solution
+ */
+void regression_print(char *label, struct regression *r, double flops) {
+    printf(
+        "%s: %.3f ms median (%.3f GFLOP/s), baseline %.3f ms (%.3f GFLOP/s), %+.1f%%\n",
+        label,
+        r->median * 1E3,
+        flops / r->median * 1E-9,
+        r->baseline * 1E3,
+        flops / r->baseline * 1E-9,
+        (r->median / r->baseline - 1.0) * 100
+    );
+    printf(
+        "%s: %d/%d samples over %.3f ms, sign test p = %.4f: %s\n",
+        label,
+        r->exceeding,
+        r->samples,
+        r->threshold * 1E3,
+        r->p_value,
+        r->regressed? "REGRESSION": "ok"
+    );
+    fflush(stdout);
+}
+
+/**
+ * @brief Compare a solution element by element with a reference one.
+ *
+ * @param A Solution to check
+ * @param reference Reference solution
+ * @param rows Number of rows
+ * @param columns Number of columns
+ * @param tolerance Maximum absolute difference allowed
+ * @param max_difference Maximum absolute difference found
+ * @return int 1 if every element is within tolerance, 0 otherwise
+ */
+int verify_solution(
+    double *A,
+    double *reference,
+    int rows,
+    int columns,
+    double tolerance,
+    double *max_difference
+) {
+    double difference;
+
+    *max_difference = 0.0;
+    for (size_t i = 0; i < (size_t) rows * columns; i++) {
+        difference = fabs(A[i] - reference[i]);
+        // NaN never compares greater, do not let it through
+        if (difference > *max_difference || difference != difference) {
+            *max_difference = difference;
+        }
+    }
+
+    return *max_difference <= tolerance;
+}
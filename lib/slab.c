@@ -0,0 +1,383 @@
+/**
+ * @file slab.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Parallel Jacobi method over row slabs.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "matrixutils.h"
+#include "jacobi.h"
+#include "largecount.h"
+#include "mpiutils.h"
+#include "perfcounters.h"
+#include "slab.h"
+
+extern const short MAX_ITERATIONS; /**< Maximum number of iterations allowed */
+extern const double CONVERGENCE_THRESHOLD; /**< Error threshold */
+
+/**
+ * @brief Compute row distribution and allocate local ghosted submatrices.
+ *
+ * @param s Slab to set up
+ * @param comm Communicator of processes sharing the matrix
+ * @param n Matrix order
+ * @param debug Debug flag
+ * @param phases Phase accumulators
+ * @param backend Ghost rows exchange backend
+ */
+void slab_create(
+    struct slab *s,
+    MPI_Comm comm,
+    int n,
+    unsigned char debug,
+    struct phases *phases,
+    enum halo_backend backend
+) {
+    int nproc;
+    int me;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    s->comm = comm;
+    s->nproc = nproc;
+    s->me = me;
+    s->n = n;
+    s->debug = debug;
+    s->phases = phases;
+    s->max_iterations = MAX_ITERATIONS;
+    s->num_iterations = 0;
+    s->diffnorm = 0.0;
+    s->snapshot = NULL;
+
+    // calculate the number of rows to distribute
+    // calculate number of elements and
+    // matrix offsets for every processor
+    if (debug && me == MASTER && nproc > 1) {
+        printf(
+            "[P%d] %d mod (%d - 1) is %d\n",
+            me,
+            n,
+            nproc,
+            (n % (nproc - 1))
+        );
+        printf("\n");
+        fflush(stdout);
+    }
+
+    s->sendcounts = malloc(nproc * sizeof *s->sendcounts);
+    s->recvcounts = malloc(nproc * sizeof *s->recvcounts);
+    s->senddispls = malloc(nproc * sizeof *s->senddispls);
+    s->recvdispls = malloc(nproc * sizeof *s->recvdispls);
+    scatterv_gatherv_describers(
+        s->sendcounts,
+        s->senddispls,
+        s->recvcounts,
+        s->recvdispls,
+        &s->local_rows,
+        nproc,
+        me,
+        n
+    );
+
+    // add 1 row to last processor, 2 rows for other ones
+    s->local_g_rows = (me != nproc - 1)?
+        s->local_rows + 2:
+        s->local_rows + 1;
+    // print number of rows, cells and offsets
+    if (debug) {
+        if (me == MASTER) {
+            for (int p = 0; p < nproc; p++)
+            {
+                printf("\n");
+                printf(
+                    "I'll send to P%d %zu cells from cell %zu\n",
+                    p,
+                    s->sendcounts[p],
+                    s->senddispls[p]
+                );
+                printf(
+                    "I'll get back from P%d %zu cells from cell %zu\n",
+                    p,
+                    s->recvcounts[p],
+                    s->recvdispls[p]
+                );
+                printf("\n");
+            }
+        }
+
+        printf(
+            "[P%d] Local ghosted matrix will have %d rows\n",
+            me,
+            s->local_g_rows
+        );
+        printf("\n");
+        printf(
+            "[P%d] Convergence threshold is %.3e\n",
+            me,
+            CONVERGENCE_THRESHOLD
+        );
+        printf("\n");
+        fflush(stdout);
+    }
+
+    // calculate inner rows indexes
+    // for row exchange among processors
+    s->first_g_row = n;
+    s->last_g_row = (s->sendcounts[me]/n - 2) * n;
+    s->last_local_row = s->last_g_row + n;
+    if (debug) {
+        printf("[P%d] First significative row index: %zu\n", me, s->first_g_row);
+        printf("[P%d] Last significative row index: %zu\n", me, s->last_g_row);
+        printf("[P%d] Last ghosted row index: %zu\n", me, s->last_local_row);
+        printf("\n");
+        fflush(stdout);
+    }
+
+    s->local_A_g = malloc(s->sendcounts[me] * sizeof *s->local_A_g);
+    // submatrix after iteration is where ghost rows get
+    // exchanged, so its memory belongs to exchange backend
+    halo_create(&s->halo, comm, n, s->sendcounts, backend, debug);
+    s->local_A_g_prime = s->halo.prime;
+}
+
+/**
+ * @brief Distribute ghosted submatrices from MASTER to every process.
+ *
+ * Ghost rows come along with the slab itself, as displacements
+ * overlap, so that nothing is to be set up by hand afterwards.
+ *
+ * @param s Slab
+ * @param A Whole matrix (significant on MASTER only), left untouched
+ */
+void slab_scatter(struct slab *s, double *A) {
+    phases_start(s->phases);
+    scatterv_large(
+        A, s->sendcounts, s->senddispls, MPI_DOUBLE,
+        s->local_A_g, MASTER, s->comm
+    );
+    phases_lap(s->phases, PHASE_SCATTER);
+}
+
+/**
+ * @brief Apply Jacobi method over local submatrices until convergence.
+ *
+ * @param s Slab
+ */
+void slab_iterate(struct slab *s) {
+    int me = s->me;
+    int n = s->n;
+    int local_g_rows = s->local_g_rows;
+    double *local_A_g = s->local_A_g;
+    double *local_A_g_prime = s->local_A_g_prime;
+    double cells = (local_g_rows - 2) * (double) (n - 2);
+    double local_diffnorm;
+    double diffnorm;
+    int num_iterations = 0;
+    int last;
+
+    phases_start(s->phases);
+    do {
+        if (s->debug) {
+            printf("[P%d] Local ghosted matrix:\n", me);
+            print_matrix_array(local_A_g, local_g_rows, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        // apply a single iteration
+        counters_begin();
+        jacobi_iteration(local_A_g, local_A_g_prime, local_g_rows, n);
+        counters_end(KERNEL_SWEEP, cells);
+        num_iterations++;
+        phases_lap(s->phases, PHASE_SWEEP);
+
+        if (s->debug) {
+            printf("[P%d] Local prime matrix:\n", me);
+            print_matrix_array(local_A_g_prime, local_g_rows, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        // check for convergence test before reiterating
+        counters_begin();
+        local_diffnorm = convergence_check_g(
+            local_A_g,
+            local_A_g_prime,
+            local_g_rows,
+            n
+        );
+        counters_end(KERNEL_RESIDUAL, cells);
+        phases_lap(s->phases, PHASE_RESIDUAL);
+        if (s->debug) {
+            printf(
+                "[P%d] At iteration %d, my local convergence value is %.3e\n",
+                me,
+                num_iterations,
+                local_diffnorm
+            );
+            fflush(stdout);
+        }
+
+        // evaluate convergence value from all processes
+        MPI_Allreduce(
+            &local_diffnorm, &diffnorm, 1,
+            MPI_DOUBLE, MPI_SUM, s->comm
+        );
+        diffnorm = sqrt(diffnorm);
+        phases_lap(s->phases, PHASE_ALLREDUCE);
+        if (s->debug && me == MASTER) {
+            printf(
+                "[P%d] At iteration %d, global convergence value is %.3e\n",
+                me,
+                num_iterations,
+                diffnorm
+            );
+            printf("\n");
+            fflush(stdout);
+        }
+
+        if (s->debug) {
+            printf("[P%d] Start row exchange...\n", me);
+            fflush(stdout);
+        }
+
+        // make sure everyone performed an iteration before
+        // exchanging rows; only sendrecv exchange keeps the global
+        // barrier of the original scheme, which baselines were
+        // recorded with, since other backends synchronize just the
+        // neighbours they exchange with: shm through its flags, rma
+        // through post/start epochs and neighbor through the
+        // neighbourhood collective itself
+        phases_start(s->phases);
+        if (s->halo.backend == HALO_SENDRECV) {
+            MPI_Barrier(s->comm);
+        }
+        phases_lap(s->phases, PHASE_BARRIER);
+
+        // exchange unghosted rows with previous
+        // and next process, the first one has
+        // no previous, the last one has no next
+        halo_exchange(&s->halo);
+        phases_lap(s->phases, PHASE_EXCHANGE);
+
+        if (s->debug) {
+            printf("[P%d] Local prime matrix:\n", me);
+            print_matrix_array(local_A_g_prime, local_g_rows, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        // swap matrices, bottom border row of last
+        // process never changes and is left alone
+        phases_start(s->phases);
+        counters_begin();
+        replace_partial(
+            local_A_g,
+            local_A_g_prime,
+            n,
+            s->first_g_row,
+            (me != s->nproc - 1)? s->last_local_row: s->last_g_row,
+            me
+        );
+        counters_end(KERNEL_COPY, cells);
+        phases_lap(s->phases, PHASE_COPY);
+
+        // hand residual and unghosted rows over to snapshot writer,
+        // last iteration's field waits for previous one to be written
+        if (s->snapshot != NULL) {
+            last = diffnorm <= CONVERGENCE_THRESHOLD ||
+                num_iterations >= s->max_iterations;
+            snapshot_residual(s->snapshot, num_iterations, diffnorm);
+            if (num_iterations % s->snapshot->every == 0 || last) {
+                snapshot_field(s->snapshot, num_iterations, &local_A_g[n], last);
+            }
+            phases_lap(s->phases, PHASE_SNAPSHOT);
+        }
+
+        if (s->debug) {
+            printf("[P%d] After swap, local matrix is now:\n", me);
+            print_matrix_array(local_A_g, local_g_rows, n);
+            printf("\n");
+            fflush(stdout);
+        }
+    } while (
+        diffnorm > CONVERGENCE_THRESHOLD &&
+        num_iterations < s->max_iterations
+    );
+
+    s->num_iterations = num_iterations;
+    s->diffnorm = diffnorm;
+}
+
+/**
+ * @brief Recollect unghosted rows of local submatrices on MASTER.
+ *
+ * Unghosted rows are contiguous within the ghosted submatrix, so they
+ * are sent from there, with no staging copy. Rows MASTER never gathers,
+ * i.e. first and last row of the whole matrix, are left untouched.
+ *
+ * @param s Slab
+ * @param A Whole matrix (significant on MASTER only)
+ */
+void slab_gather(struct slab *s, double *A) {
+    int me = s->me;
+    int n = s->n;
+
+    phases_start(s->phases);
+    if (s->debug) {
+        printf(
+            "[P%d] Sending %dx%d local matrix from %dx%d ghosted one...\n",
+            me,
+            s->local_rows,
+            n,
+            s->local_g_rows,
+            n
+        );
+        printf("[P%d] Local unghosted submatrix:\n", me);
+        print_matrix_array(&s->local_A_g[n], s->local_rows, n);
+        printf("\n");
+        fflush(stdout);
+    }
+
+    // first unghosted row is one row past ghosted one
+    gatherv_large(
+        &s->local_A_g[n], A, s->recvcounts, s->recvdispls, MPI_DOUBLE,
+        MASTER, s->comm
+    );
+    if (s->debug && me == MASTER) {
+        printf(
+            "[P%d] After %d iteration, matrix is:\n",
+            me,
+            s->num_iterations
+        );
+        print_matrix_array(A, n, n);
+        printf("\n");
+        fflush(stdout);
+    }
+    phases_lap(s->phases, PHASE_GATHER);
+}
+
+/**
+ * @brief Free local submatrices and describers.
+ *
+ * @param s Slab
+ */
+void slab_free(struct slab *s) {
+    free(s->local_A_g);
+    halo_free(&s->halo);
+    s->local_A_g_prime = NULL;
+    free(s->sendcounts);
+    free(s->senddispls);
+    free(s->recvcounts);
+    free(s->recvdispls);
+}
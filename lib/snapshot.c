@@ -0,0 +1,285 @@
+/**
+ * @file snapshot.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief In-situ snapshots written in background.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _XOPEN_SOURCE 700 /**< Use clock_gettime definition from POSIX */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "jacobi.h"
+#include "snapshot.h"
+
+/**
+ * @brief Seconds elapsed on monotonic clock.
+ *
+ * @return double Seconds
+ */
+static double now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec * 1E-9;
+}
+
+/**
+ * @brief Write staged rows of a field snapshot.
+ *
+ * File holds iteration, global index of first sampled row, sampled
+ * rows and columns and stride as `int`s, then sampled elements
+ * row by row.
+ *
+ * @param s Snapshots
+ * @return int 0 on success, -1 on error
+ */
+static int write_field(struct snapshot *s) {
+    char name[FILENAME_MAX];
+    FILE *file;
+    int header[5] = {s->field_iteration, s->first_row, s->rows, s->cols, s->stride};
+    size_t count = (size_t) s->rows * s->cols;
+    int status = 0;
+
+    snprintf(
+        name, sizeof name, "%s-%d-i%d-p%d.bin",
+        s->prefix, s->n, s->field_iteration, s->rank
+    );
+    file = fopen(name, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    if (fwrite(header, sizeof *header, 5, file) != 5 ||
+        fwrite(s->field, sizeof *s->field, count, file) != count) {
+        status = -1;
+    }
+    fclose(file);
+
+    return status;
+}
+
+/**
+ * @brief Write staged residual history.
+ *
+ * @param s Snapshots
+ * @return int 0 on success, -1 on error
+ */
+static int write_history(struct snapshot *s) {
+    char name[FILENAME_MAX];
+    FILE *file;
+
+    snprintf(name, sizeof name, "%s-%d-residuals.csv", s->prefix, s->n);
+    file = fopen(name, "w");
+    if (file == NULL) {
+        return -1;
+    }
+    fprintf(file, "\"Iteration\",\"Residual\"\n");
+    for (int i = 0; i < s->history_out_count; i++) {
+        fprintf(file, "%d,%e\n", i + 1, s->history_out[i]);
+    }
+    fclose(file);
+
+    return 0;
+}
+
+/**
+ * @brief Body of writer thread.
+ *
+ * Staged buffers are written with no lock held, the solver leaves
+ * them alone until their pending flag is cleared.
+ *
+ * @param arg Snapshots
+ * @return void* Always NULL
+ */
+static void *writer_run(void *arg) {
+    struct snapshot *s = arg;
+    double start;
+    int field;
+    int status;
+
+    pthread_mutex_lock(&s->lock);
+    while (1) {
+        while (!s->field_pending && !s->history_pending && !s->quit) {
+            pthread_cond_wait(&s->wake, &s->lock);
+        }
+        if (!s->field_pending && !s->history_pending) {
+            break;
+        }
+
+        field = s->field_pending;
+        pthread_mutex_unlock(&s->lock);
+        start = now();
+        if (field) {
+            status = write_field(s);
+        } else {
+            status = write_history(s);
+        }
+        pthread_mutex_lock(&s->lock);
+
+        s->write_seconds += now() - start;
+        s->failed |= status != 0;
+        if (field) {
+            s->field_pending = 0;
+            s->taken++;
+        } else {
+            s->history_pending = 0;
+        }
+        pthread_cond_broadcast(&s->idle);
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Set up snapshots of a process and start its writer thread.
+ *
+ * Every `stride` rows and columns of the matrix are sampled, by global
+ * index, so that snapshots of every process fit together.
+ *
+ * @param s Snapshots
+ * @param prefix Snapshot files prefix
+ * @param n Matrix order
+ * @param rank Rank of this process
+ * @param every Iterations between field snapshots
+ * @param stride Rows and columns between sampled elements, 1 for full field
+ * @param first_row Global index of first row of this process
+ * @param local_rows Rows of this process
+ */
+void snapshot_create(
+    struct snapshot *s,
+    char *prefix,
+    int n,
+    int rank,
+    int every,
+    int stride,
+    int first_row,
+    int local_rows
+) {
+    memset(s, 0, sizeof *s);
+    s->prefix = prefix;
+    s->n = n;
+    s->rank = rank;
+    s->every = every;
+    s->stride = stride;
+    s->local_first = (stride - first_row % stride) % stride;
+    s->first_row = first_row + s->local_first;
+    s->rows = (s->local_first < local_rows)?
+        (local_rows - s->local_first + stride - 1) / stride:
+        0;
+    s->cols = (n + stride - 1) / stride;
+    s->field = malloc((size_t) s->rows * s->cols * sizeof *s->field);
+    s->history = malloc(MAX_ITERATIONS * sizeof *s->history);
+    s->history_out = malloc(MAX_ITERATIONS * sizeof *s->history_out);
+
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->wake, NULL);
+    pthread_cond_init(&s->idle, NULL);
+    pthread_create(&s->writer, NULL, writer_run, s);
+}
+
+/**
+ * @brief Record residual of an iteration.
+ *
+ * @param s Snapshots
+ * @param iteration Iteration, from 1
+ * @param residual Residual after iteration
+ */
+void snapshot_residual(struct snapshot *s, int iteration, double residual) {
+    if (iteration == 1) {
+        s->history_count = 0;
+    }
+    if (s->history_count < MAX_ITERATIONS) {
+        s->history[s->history_count++] = residual;
+    }
+}
+
+/**
+ * @brief Hand sampled rows over to writer thread.
+ *
+ * Unless forced, never waits for the filesystem: if the writer is
+ * still busy with previous snapshot, this one is dropped. A forced
+ * snapshot, such as the field a solution ends with, waits for previous
+ * one to be written instead.
+ *
+ * @param s Snapshots
+ * @param iteration Iteration, from 1
+ * @param rows Unghosted rows of this process
+ * @param force Whether to wait for writer rather than drop snapshot
+ */
+void snapshot_field(struct snapshot *s, int iteration, double *rows, int force) {
+    int n = s->n;
+    int busy;
+
+    pthread_mutex_lock(&s->lock);
+    while (force && s->field_pending) {
+        pthread_cond_wait(&s->idle, &s->lock);
+    }
+    busy = s->field_pending;
+    pthread_mutex_unlock(&s->lock);
+    if (busy) {
+        s->dropped++;
+        return;
+    }
+
+    for (int i = 0; i < s->rows; i++) {
+        double *row = &rows[(size_t) (s->local_first + i * s->stride) * n];
+
+        for (int j = 0; j < s->cols; j++) {
+            s->field[(size_t) i * s->cols + j] = row[j * s->stride];
+        }
+    }
+    s->field_iteration = iteration;
+
+    pthread_mutex_lock(&s->lock);
+    s->field_pending = 1;
+    pthread_cond_signal(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+}
+
+/**
+ * @brief Hand residual history of a solution over to writer thread.
+ *
+ * Meant to be called out of the solver loop, it waits for previous
+ * history to be written.
+ *
+ * @param s Snapshots
+ */
+void snapshot_flush(struct snapshot *s) {
+    pthread_mutex_lock(&s->lock);
+    while (s->history_pending) {
+        pthread_cond_wait(&s->idle, &s->lock);
+    }
+    memcpy(s->history_out, s->history, s->history_count * sizeof *s->history);
+    s->history_out_count = s->history_count;
+    s->history_pending = 1;
+    pthread_cond_signal(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+}
+
+/**
+ * @brief Wait for pending snapshots, stop writer thread and free memory.
+ *
+ * @param s Snapshots
+ */
+void snapshot_free(struct snapshot *s) {
+    pthread_mutex_lock(&s->lock);
+    s->quit = 1;
+    pthread_cond_signal(&s->wake);
+    pthread_mutex_unlock(&s->lock);
+    pthread_join(s->writer, NULL);
+
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->wake);
+    pthread_cond_destroy(&s->idle);
+    free(s->field);
+    free(s->history);
+    free(s->history_out);
+}
@@ -0,0 +1,419 @@
+/**
+ * @file sparse.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Parallel Jacobi method over sparse systems.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "jacobi.h"
+#include "largecount.h"
+#include "mpiutils.h"
+#include "sparse.h"
+
+/**
+ * @brief Compare integers.
+ *
+ * @param a An integer
+ * @param b Another integer
+ * @return int Negative, zero or positive as `qsort` wants
+ */
+static int int_compare(const void *a, const void *b) {
+    int ia = *(const int *) a;
+    int ib = *(const int *) b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+/**
+ * @brief Split rows so that every process gets about as many nonzeros.
+ *
+ * Every process gets at least a row.
+ *
+ * @param A Whole matrix
+ * @param nproc Number of processes
+ * @param rowdispls First row of every process, then order
+ */
+static void partition_rows(struct csr *A, int nproc, int *rowdispls) {
+    int r = 0;
+    double target;
+
+    rowdispls[0] = 0;
+    for (int p = 1; p < nproc; p++) {
+        target = (double) A->nnz * p / nproc;
+        while (r < A->rows && A->row_ptr[r] < target) {
+            r++;
+        }
+        if (r < rowdispls[p - 1] + 1) {
+            r = rowdispls[p - 1] + 1;
+        }
+        if (r > A->rows - (nproc - p)) {
+            r = A->rows - (nproc - p);
+        }
+        rowdispls[p] = r;
+    }
+    rowdispls[nproc] = A->rows;
+}
+
+/**
+ * @brief Distribute rows from MASTER and build the ghost entries pattern.
+ *
+ * Rows are split by nonzeros. Every process lists the columns of its
+ * rows owned by others, sorted, so that they are grouped by owner, and
+ * tells every owner which of its entries it needs; local rows are split
+ * into interior ones, updated while ghost entries are in flight, and
+ * boundary ones. Collective over the communicator.
+ *
+ * @param s Sparse system to set up
+ * @param comm Communicator of processes sharing the system
+ * @param A Whole matrix (significant on MASTER only)
+ * @param phases Phase accumulators
+ * @return int 0 on success, -1 if a diagonal element is missing or zero
+ * on some process
+ */
+int sparse_create(struct sparse *s, MPI_Comm comm, struct csr *A, struct phases *phases) {
+    int nproc;
+    int me;
+    size_t *nnzcounts;
+    size_t *nnzdispls;
+    int *from_counts;
+    int *from_displs;
+    int *to_counts;
+    int *to_displs;
+    int *ghost_cols;
+    int *send_cols;
+    size_t local_nnz;
+    size_t base;
+    int owner;
+    int sent;
+    int status;
+    int interior;
+    int *found;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    s->comm = comm;
+    s->nproc = nproc;
+    s->me = me;
+    s->phases = phases;
+    s->max_iterations = MAX_ITERATIONS;
+    s->num_iterations = 0;
+    s->diffnorm = 0.0;
+
+    // partition rows by nonzeros
+    s->rowdispls = malloc((nproc + 1) * sizeof *s->rowdispls);
+    s->rowcounts = malloc(nproc * sizeof *s->rowcounts);
+    nnzcounts = malloc(nproc * sizeof *nnzcounts);
+    nnzdispls = malloc(nproc * sizeof *nnzdispls);
+    if (me == MASTER) {
+        s->n = A->rows;
+        partition_rows(A, nproc, s->rowdispls);
+        for (int p = 0; p < nproc; p++) {
+            nnzdispls[p] = A->row_ptr[s->rowdispls[p]];
+            nnzcounts[p] = A->row_ptr[s->rowdispls[p + 1]] - nnzdispls[p];
+        }
+    }
+    MPI_Bcast(&s->n, 1, MPI_INT, MASTER, comm);
+    MPI_Bcast(s->rowdispls, nproc + 1, MPI_INT, MASTER, comm);
+    MPI_Bcast(nnzcounts, nproc, MPI_SIZE_T, MASTER, comm);
+    MPI_Bcast(nnzdispls, nproc, MPI_SIZE_T, MASTER, comm);
+    for (int p = 0; p < nproc; p++) {
+        s->rowcounts[p] = s->rowdispls[p + 1] - s->rowdispls[p];
+    }
+    s->first_row = s->rowdispls[me];
+    s->local_rows = s->rowcounts[me];
+    local_nnz = nnzcounts[me];
+
+    // distribute rows, with global columns for now
+    s->local.rows = s->local_rows;
+    s->local.nnz = local_nnz;
+    s->local.row_ptr = malloc((s->local_rows + 1) * sizeof *s->local.row_ptr);
+    s->local.col = malloc(local_nnz * sizeof *s->local.col);
+    s->local.val = malloc(local_nnz * sizeof *s->local.val);
+    MPI_Scatterv(
+        (me == MASTER)? A->row_ptr: NULL, s->rowcounts, s->rowdispls, MPI_SIZE_T,
+        s->local.row_ptr, s->local_rows, MPI_SIZE_T,
+        MASTER, comm
+    );
+    scatterv_large(
+        (me == MASTER)? A->col: NULL, nnzcounts, nnzdispls, MPI_INT,
+        s->local.col, MASTER, comm
+    );
+    scatterv_large(
+        (me == MASTER)? A->val: NULL, nnzcounts, nnzdispls, MPI_DOUBLE,
+        s->local.val, MASTER, comm
+    );
+    base = s->local.row_ptr[0];
+    for (int i = 0; i < s->local_rows; i++) {
+        s->local.row_ptr[i] -= base;
+    }
+    s->local.row_ptr[s->local_rows] = local_nnz;
+    free(nnzcounts);
+    free(nnzdispls);
+
+    // list columns owned by others, sorted and unique
+    ghost_cols = malloc((local_nnz + 1) * sizeof *ghost_cols);
+    s->ghosts = 0;
+    for (size_t k = 0; k < local_nnz; k++) {
+        if (s->local.col[k] < s->first_row ||
+            s->local.col[k] >= s->first_row + s->local_rows) {
+            ghost_cols[s->ghosts++] = s->local.col[k];
+        }
+    }
+    qsort(ghost_cols, s->ghosts, sizeof *ghost_cols, int_compare);
+    if (s->ghosts > 0) {
+        int unique = 1;
+
+        for (int g = 1; g < s->ghosts; g++) {
+            if (ghost_cols[g] != ghost_cols[unique - 1]) {
+                ghost_cols[unique++] = ghost_cols[g];
+            }
+        }
+        s->ghosts = unique;
+    }
+    s->local.cols = s->local_rows + s->ghosts;
+
+    // number owned columns first, ghost entries after them
+    for (size_t k = 0; k < local_nnz; k++) {
+        int c = s->local.col[k];
+
+        if (c >= s->first_row && c < s->first_row + s->local_rows) {
+            s->local.col[k] = c - s->first_row;
+        } else {
+            found = bsearch(&c, ghost_cols, s->ghosts, sizeof *ghost_cols, int_compare);
+            s->local.col[k] = s->local_rows + (int) (found - ghost_cols);
+        }
+    }
+
+    // count ghost entries by owner, owners come in rank order
+    from_counts = calloc(nproc, sizeof *from_counts);
+    owner = 0;
+    for (int g = 0; g < s->ghosts; g++) {
+        while (ghost_cols[g] >= s->rowdispls[owner + 1]) {
+            owner++;
+        }
+        from_counts[owner]++;
+    }
+
+    // tell every owner which of its entries are needed
+    to_counts = malloc(nproc * sizeof *to_counts);
+    to_displs = malloc(nproc * sizeof *to_displs);
+    MPI_Alltoall(from_counts, 1, MPI_INT, to_counts, 1, MPI_INT, comm);
+    sent = 0;
+    for (int p = 0; p < nproc; p++) {
+        to_displs[p] = sent;
+        sent += to_counts[p];
+    }
+    send_cols = malloc((sent + 1) * sizeof *send_cols);
+    from_displs = malloc(nproc * sizeof *from_displs);
+    from_displs[0] = 0;
+    for (int p = 1; p < nproc; p++) {
+        from_displs[p] = from_displs[p - 1] + from_counts[p - 1];
+    }
+    MPI_Alltoallv(
+        ghost_cols, from_counts, from_displs, MPI_INT,
+        send_cols, to_counts, to_displs, MPI_INT,
+        comm
+    );
+
+    // keep neighbours only
+    s->recv_ranks = malloc(nproc * sizeof *s->recv_ranks);
+    s->recv_counts = malloc(nproc * sizeof *s->recv_counts);
+    s->recv_displs = malloc(nproc * sizeof *s->recv_displs);
+    s->recv_neighbours = 0;
+    for (int p = 0; p < nproc; p++) {
+        if (from_counts[p] > 0) {
+            s->recv_ranks[s->recv_neighbours] = p;
+            s->recv_counts[s->recv_neighbours] = from_counts[p];
+            s->recv_displs[s->recv_neighbours++] = s->local_rows + from_displs[p];
+        }
+    }
+    s->send_ranks = malloc(nproc * sizeof *s->send_ranks);
+    s->send_counts = malloc(nproc * sizeof *s->send_counts);
+    s->send_displs = malloc(nproc * sizeof *s->send_displs);
+    s->send_neighbours = 0;
+    for (int p = 0; p < nproc; p++) {
+        if (to_counts[p] > 0) {
+            s->send_ranks[s->send_neighbours] = p;
+            s->send_counts[s->send_neighbours] = to_counts[p];
+            s->send_displs[s->send_neighbours++] = to_displs[p];
+        }
+    }
+    s->send_index = send_cols;
+    for (int k = 0; k < sent; k++) {
+        s->send_index[k] -= s->first_row;
+    }
+    s->send_buffer = malloc((sent + 1) * sizeof *s->send_buffer);
+    s->requests = malloc(
+        (s->recv_neighbours + s->send_neighbours + 1) * sizeof *s->requests
+    );
+    free(ghost_cols);
+    free(from_counts);
+    free(from_displs);
+    free(to_counts);
+    free(to_displs);
+
+    // split interior and boundary rows
+    s->interior = malloc((s->local_rows + 1) * sizeof *s->interior);
+    s->boundary = malloc((s->local_rows + 1) * sizeof *s->boundary);
+    s->interior_count = 0;
+    s->boundary_count = 0;
+    for (int i = 0; i < s->local_rows; i++) {
+        interior = 1;
+        for (size_t k = s->local.row_ptr[i]; k < s->local.row_ptr[i + 1]; k++) {
+            interior &= s->local.col[k] < s->local_rows;
+        }
+        if (interior) {
+            s->interior[s->interior_count++] = i;
+        } else {
+            s->boundary[s->boundary_count++] = i;
+        }
+    }
+
+    s->local_b = malloc((s->local_rows + 1) * sizeof *s->local_b);
+    s->inv_diag = malloc((s->local_rows + 1) * sizeof *s->inv_diag);
+    s->x = malloc((s->local.cols + 1) * sizeof *s->x);
+    s->x_new = malloc((s->local_rows + 1) * sizeof *s->x_new);
+    status = csr_inverse_diagonal(&s->local, s->inv_diag);
+    MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MIN, comm);
+
+    return status;
+}
+
+/**
+ * @brief Distribute known terms from MASTER to every process.
+ *
+ * @param s Sparse system
+ * @param b Whole known terms (significant on MASTER only)
+ */
+void sparse_scatter(struct sparse *s, double *b) {
+    phases_start(s->phases);
+    MPI_Scatterv(
+        b, s->rowcounts, s->rowdispls, MPI_DOUBLE,
+        s->local_b, s->local_rows, MPI_DOUBLE,
+        MASTER, s->comm
+    );
+    phases_lap(s->phases, PHASE_SCATTER);
+}
+
+/**
+ * @brief Apply Jacobi method over local rows until convergence.
+ *
+ * Every iteration sends owned entries needed by other processes and
+ * receives ghost entries, updating interior rows in the meantime.
+ *
+ * @param s Sparse system
+ */
+void sparse_iterate(struct sparse *s) {
+    double local_diffnorm;
+    double diffnorm;
+    int num_iterations = 0;
+    int requests;
+
+    phases_start(s->phases);
+    memset(s->x, 0, s->local.cols * sizeof *s->x);
+    do {
+        requests = 0;
+        for (int q = 0; q < s->recv_neighbours; q++) {
+            MPI_Irecv(
+                &s->x[s->recv_displs[q]], s->recv_counts[q], MPI_DOUBLE,
+                s->recv_ranks[q], TAG, s->comm, &s->requests[requests++]
+            );
+        }
+        for (int q = 0; q < s->send_neighbours; q++) {
+            double *buffer = &s->send_buffer[s->send_displs[q]];
+            int *index = &s->send_index[s->send_displs[q]];
+
+            for (int k = 0; k < s->send_counts[q]; k++) {
+                buffer[k] = s->x[index[k]];
+            }
+            MPI_Isend(
+                buffer, s->send_counts[q], MPI_DOUBLE,
+                s->send_ranks[q], TAG, s->comm, &s->requests[requests++]
+            );
+        }
+        phases_lap(s->phases, PHASE_EXCHANGE);
+
+        local_diffnorm = csr_sweep(
+            &s->local, s->local_b, s->inv_diag, s->x, s->x_new,
+            s->interior, s->interior_count
+        );
+        phases_lap(s->phases, PHASE_SWEEP);
+
+        MPI_Waitall(requests, s->requests, MPI_STATUSES_IGNORE);
+        phases_lap(s->phases, PHASE_EXCHANGE);
+
+        local_diffnorm += csr_sweep(
+            &s->local, s->local_b, s->inv_diag, s->x, s->x_new,
+            s->boundary, s->boundary_count
+        );
+        num_iterations++;
+        phases_lap(s->phases, PHASE_SWEEP);
+
+        MPI_Allreduce(
+            &local_diffnorm, &diffnorm, 1,
+            MPI_DOUBLE, MPI_SUM, s->comm
+        );
+        diffnorm = sqrt(diffnorm);
+        phases_lap(s->phases, PHASE_ALLREDUCE);
+
+        memcpy(s->x, s->x_new, s->local_rows * sizeof *s->x);
+        phases_lap(s->phases, PHASE_COPY);
+    } while (
+        diffnorm > CONVERGENCE_THRESHOLD &&
+        num_iterations < s->max_iterations
+    );
+
+    s->num_iterations = num_iterations;
+    s->diffnorm = diffnorm;
+}
+
+/**
+ * @brief Recollect solution on MASTER.
+ *
+ * @param s Sparse system
+ * @param x Whole solution (significant on MASTER only)
+ */
+void sparse_gather(struct sparse *s, double *x) {
+    phases_start(s->phases);
+    MPI_Gatherv(
+        s->x, s->local_rows, MPI_DOUBLE,
+        x, s->rowcounts, s->rowdispls, MPI_DOUBLE,
+        MASTER, s->comm
+    );
+    phases_lap(s->phases, PHASE_GATHER);
+}
+
+/**
+ * @brief Free local rows, exchange pattern and describers.
+ *
+ * @param s Sparse system
+ */
+void sparse_free(struct sparse *s) {
+    csr_free(&s->local);
+    free(s->local_b);
+    free(s->inv_diag);
+    free(s->x);
+    free(s->x_new);
+    free(s->interior);
+    free(s->boundary);
+    free(s->recv_ranks);
+    free(s->recv_counts);
+    free(s->recv_displs);
+    free(s->send_ranks);
+    free(s->send_counts);
+    free(s->send_displs);
+    free(s->send_index);
+    free(s->send_buffer);
+    free(s->requests);
+    free(s->rowdispls);
+    free(s->rowcounts);
+}
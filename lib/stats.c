@@ -0,0 +1,132 @@
+/**
+ * @file stats.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Timing statistics functions.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _XOPEN_SOURCE 700 /**< Use getrusage definition from POSIX */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/resource.h>
+
+#include "stats.h"
+
+/**
+ * @brief Comparison function for qsort over doubles.
+ *
+ * @param a Pointer to first double
+ * @param b Pointer to second double
+ * @return int Negative, zero or positive as in strcmp
+ */
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sort an array of doubles in ascending order.
+ *
+ * @param values Values to sort
+ * @param count Number of values
+ */
+void sort_doubles(double *values, int count) {
+    qsort(values, count, sizeof *values, compare_doubles);
+}
+
+/**
+ * @brief Percentile of sorted values, linearly interpolated.
+ *
+ * @param sorted Values in ascending order
+ * @param count Number of values
+ * @param p Percentile in range [0, 100]
+ * @return double Percentile value
+ */
+double percentile(double *sorted, int count, double p) {
+    double position;
+    int lower;
+
+    if (count <= 0) {
+        return 0.0;
+    }
+
+    position = p / 100.0 * (count - 1);
+    lower = (int) floor(position);
+    if (lower >= count - 1) {
+        return sorted[count - 1];
+    }
+
+    return sorted[lower] +
+        (position - lower) * (sorted[lower + 1] - sorted[lower]);
+}
+
+/**
+ * @brief Summarize repeated time measurements.
+ *
+ * @param times Measured times (left untouched)
+ * @param count Number of measurements
+ * @param stats Summary of measurements
+ */
+void summarize_times(double *times, int count, struct time_stats *stats) {
+    double *sorted = malloc(count * sizeof *sorted);
+
+    memcpy(sorted, times, count * sizeof *sorted);
+    sort_doubles(sorted, count);
+    stats->median = percentile(sorted, count, 50);
+    stats->min = sorted[0];
+    stats->max = sorted[count - 1];
+    stats->p05 = percentile(sorted, count, 5);
+    stats->p95 = percentile(sorted, count, 95);
+    stats->samples = count;
+    free(sorted);
+}
+
+/**
+ * @brief Check whether repeated measurements have settled.
+ *
+ * Measurements are stable when the median of all of them moved less
+ * than the given tolerance from the median without the last `window`
+ * ones.
+ *
+ * @param times Measured times
+ * @param count Number of measurements
+ * @param window Number of latest measurements to leave out
+ * @param tolerance Relative tolerance (e.g. 0.01 for 1%)
+ * @return int 1 if stable, 0 otherwise
+ */
+int times_stable(double *times, int count, int window, double tolerance) {
+    struct time_stats all;
+    struct time_stats previous;
+
+    if (count <= window) {
+        return 0;
+    }
+
+    summarize_times(times, count, &all);
+    summarize_times(times, count - window, &previous);
+
+    return fabs(all.median - previous.median) <= tolerance * all.median;
+}
+
+/**
+ * @brief Peak resident memory of this process so far.
+ *
+ * @return double Bytes, 0 if unknown
+ */
+double peak_memory(void) {
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+
+    // Linux reports kilobytes
+    return usage.ru_maxrss * 1024.0;
+}
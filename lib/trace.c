@@ -0,0 +1,213 @@
+/**
+ * @file trace.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Per-rank timelines in Chrome trace format.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "mpiutils.h"
+#include "phases.h"
+#include "trace.h"
+
+/**
+ * @brief Allocate the timeline of a rank.
+ *
+ * @param t Timeline
+ * @param capacity Events kept, latest ones win
+ */
+void trace_create(struct trace *t, int capacity) {
+    t->events = malloc(capacity * sizeof *t->events);
+    t->capacity = capacity;
+    t->recorded = 0;
+}
+
+/**
+ * @brief Record a phase, overwriting the oldest one if full.
+ *
+ * @param t Timeline
+ * @param phase Phase
+ * @param begin Local time phase began at
+ * @param end Local time phase ended at
+ */
+void trace_record(struct trace *t, int phase, double begin, double end) {
+    struct trace_event *e = &t->events[t->recorded++ % t->capacity];
+
+    e->begin = begin;
+    e->end = end;
+    e->phase = phase;
+}
+
+/**
+ * @brief Offset of MASTER clock against the one of this rank.
+ *
+ * Every rank in turn takes round trips to MASTER, which answers with
+ * its own time; the shortest round trip gives the estimate, taking
+ * MASTER time as read halfway through it. Collective over the
+ * communicator.
+ *
+ * @param comm Communicator
+ * @return double Seconds to add to local times, 0 on MASTER
+ */
+static double clock_offset(MPI_Comm comm) {
+    int nproc;
+    int me;
+    double sent;
+    double received;
+    double remote;
+    double best = -1.0;
+    double offset = 0.0;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    for (int p = 0; p < nproc; p++) {
+        if (p == MASTER) {
+            continue;
+        }
+        for (int r = 0; r < TRACE_SYNC_ROUNDS; r++) {
+            if (me == MASTER) {
+                MPI_Recv(NULL, 0, MPI_DOUBLE, p, TAG, comm, MPI_STATUS_IGNORE);
+                remote = MPI_Wtime();
+                MPI_Send(&remote, 1, MPI_DOUBLE, p, TAG, comm);
+            } else if (me == p) {
+                sent = MPI_Wtime();
+                MPI_Send(NULL, 0, MPI_DOUBLE, MASTER, TAG, comm);
+                MPI_Recv(&remote, 1, MPI_DOUBLE, MASTER, TAG, comm, MPI_STATUS_IGNORE);
+                received = MPI_Wtime();
+                if (best < 0.0 || received - sent < best) {
+                    best = received - sent;
+                    offset = remote - (sent + received) / 2;
+                }
+            }
+        }
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Merge timelines of every rank into a Chrome trace file.
+ *
+ * Times of every rank are moved onto MASTER clock, then shifted so
+ * that the earliest event starts at zero; every rank is a process of
+ * the trace, as `chrome://tracing` and Perfetto show them. Meant to be
+ * called right before `MPI_Finalize`. Collective over the communicator.
+ *
+ * @param t Timeline of this rank
+ * @param file Trace file name (significant on MASTER only)
+ * @param comm Communicator
+ * @return int 0 on success, -1 if file cannot be written (on MASTER only)
+ */
+int trace_write(struct trace *t, const char *file, MPI_Comm comm) {
+    int nproc;
+    int me;
+    int count = (t->recorded < t->capacity)? (int) t->recorded: t->capacity;
+    long first = t->recorded - count;
+    long overwritten = first;
+    double offset = clock_offset(comm);
+    double *local = malloc((3 * (size_t) count + 1) * sizeof *local);
+    double *all = NULL;
+    int *counts = NULL;
+    int *displs = NULL;
+    double origin;
+    FILE *trace;
+    int status = 0;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    // oldest event first, on MASTER clock
+    for (int i = 0; i < count; i++) {
+        struct trace_event *e = &t->events[(first + i) % t->capacity];
+
+        local[3 * i] = e->begin + offset;
+        local[3 * i + 1] = e->end + offset;
+        local[3 * i + 2] = e->phase;
+    }
+    count *= 3;
+
+    if (me == MASTER) {
+        counts = malloc(nproc * sizeof *counts);
+        displs = malloc(nproc * sizeof *displs);
+    }
+    MPI_Gather(&count, 1, MPI_INT, counts, 1, MPI_INT, MASTER, comm);
+    MPI_Reduce(
+        me == MASTER? MPI_IN_PLACE: &overwritten, &overwritten, 1, MPI_LONG, MPI_SUM,
+        MASTER, comm
+    );
+    if (me == MASTER) {
+        displs[0] = 0;
+        for (int p = 1; p < nproc; p++) {
+            displs[p] = displs[p - 1] + counts[p - 1];
+        }
+        all = malloc((displs[nproc - 1] + counts[nproc - 1] + 1) * sizeof *all);
+    }
+    MPI_Gatherv(local, count, MPI_DOUBLE, all, counts, displs, MPI_DOUBLE, MASTER, comm);
+    free(local);
+
+    if (me == MASTER) {
+        origin = -1.0;
+        for (int i = 0; i < displs[nproc - 1] + counts[nproc - 1]; i += 3) {
+            if (origin < 0.0 || all[i] < origin) {
+                origin = all[i];
+            }
+        }
+
+        trace = fopen(file, "w");
+        if (trace == NULL) {
+            status = -1;
+        } else {
+            fprintf(
+                trace,
+                "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"ranks\":%d,\"overwritten\":%ld},\n"
+                "\"traceEvents\":[\n",
+                nproc,
+                overwritten
+            );
+            for (int p = 0; p < nproc; p++) {
+                fprintf(
+                    trace,
+                    "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,"
+                    "\"args\":{\"name\":\"P%d\"}}",
+                    p == 0? "": ",\n",
+                    p,
+                    p
+                );
+                for (int i = displs[p]; i < displs[p] + counts[p]; i += 3) {
+                    fprintf(
+                        trace,
+                        ",\n{\"name\":\"%s\",\"cat\":\"jacobi\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,"
+                        "\"ts\":%.3f,\"dur\":%.3f}",
+                        PHASE_NAMES[(int) all[i + 2]],
+                        p,
+                        (all[i] - origin) * 1E6,
+                        (all[i + 1] - all[i]) * 1E6
+                    );
+                }
+            }
+            fprintf(trace, "\n]}\n");
+            fclose(trace);
+        }
+    }
+    free(all);
+    free(counts);
+    free(displs);
+
+    return status;
+}
+
+/**
+ * @brief Free memory held by a timeline.
+ *
+ * @param t Timeline
+ */
+void trace_free(struct trace *t) {
+    free(t->events);
+    t->events = NULL;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file tune.c
+ * @ingroup libraries
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Autotuning of communication parameters.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+#include "compress.h"
+#include "halo.h"
+#include "mpiutils.h"
+#include "phases.h"
+#include "slab.h"
+#include "stats.h"
+#include "tune.h"
+
+/**
+ * @brief Look up the tuned configuration of a problem in cache file.
+ *
+ * Records are `host,size,processors,exchange,compression,time` lines;
+ * last matching record wins, so that tuning again needs no rewriting.
+ *
+ * @param tune_file Tuning cache file
+ * @param host Host name
+ * @param n Matrix order
+ * @param nproc Number of processes
+ * @param t Tuned configuration
+ * @return int 0 if found, -1 otherwise
+ */
+int tune_lookup(const char *tune_file, char *host, int n, int nproc, struct tuning *t) {
+    FILE *cache = fopen(tune_file, "r");
+    char line[512];
+    char record_host[256];
+    char backend[32];
+    char compress[32];
+    int record_n;
+    int record_nproc;
+    double time;
+    int found = -1;
+
+    if (cache == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof line, cache) != NULL) {
+        // header and malformed lines do not scan
+        if (sscanf(
+                line, "%255[^,],%d,%d,%31[^,],%31[^,],%lf",
+                record_host, &record_n, &record_nproc, backend, compress, &time
+            ) == 6 &&
+            strcmp(record_host, host) == 0 && record_n == n && record_nproc == nproc &&
+            halo_parse(backend) >= 0 && compress_parse(compress) >= 0) {
+            t->backend = halo_parse(backend);
+            t->compress = compress_parse(compress);
+            t->time = time;
+            found = 0;
+        }
+    }
+    fclose(cache);
+
+    return found;
+}
+
+/**
+ * @brief Append the tuned configuration of a problem to cache file.
+ *
+ * @param tune_file Tuning cache file
+ * @param host Host name
+ * @param n Matrix order
+ * @param nproc Number of processes
+ * @param t Tuned configuration
+ * @return int 0 on success, -1 if file cannot be written
+ */
+int tune_record(const char *tune_file, char *host, int n, int nproc, struct tuning *t) {
+    FILE *cache = fopen(tune_file, "a+");
+
+    if (cache == NULL) {
+        return -1;
+    }
+    // new files get a header
+    fseek(cache, 0, SEEK_END);
+    if (ftell(cache) == 0) {
+        fprintf(cache, "\"Host\",\"Size\",\"Processors\",\"Exchange\",\"Compression\",\"Time\"\n");
+    }
+    fprintf(
+        cache, "%s,%d,%d,%s,%s,%e\n",
+        host, n, nproc, HALO_NAMES[t->backend], COMPRESS_NAMES[t->compress], t->time
+    );
+    fclose(cache);
+
+    return 0;
+}
+
+/**
+ * @brief Time a few short solutions of a configuration.
+ *
+ * @param comm Communicator of processes sharing the matrix
+ * @param n Matrix order
+ * @param A Matrix to solve (significant on MASTER only)
+ * @param t Configuration to time
+ * @param trials Number of trial solutions
+ * @return double Median time of slowest process
+ */
+static double tune_trial(MPI_Comm comm, int n, double *A, struct tuning *t, int trials) {
+    struct slab slab;
+    struct phases phases;
+    struct time_stats time_stats;
+    double *samples = malloc(trials * sizeof *samples);
+    double start;
+    double elapsed;
+
+    phases_reset(&phases);
+    slab_create(&slab, comm, n, 0, &phases, t->backend);
+    if (t->compress != COMPRESS_NONE) {
+        halo_compress(&slab.halo, t->compress);
+    }
+    slab.max_iterations = TUNE_ITERATIONS;
+    for (int r = 0; r < trials; r++) {
+        slab_scatter(&slab, A);
+        MPI_Barrier(comm);
+        start = MPI_Wtime();
+        slab_iterate(&slab);
+        elapsed = MPI_Wtime() - start;
+        MPI_Allreduce(&elapsed, &samples[r], 1, MPI_DOUBLE, MPI_MAX, comm);
+    }
+    slab_free(&slab);
+
+    summarize_times(samples, trials, &time_stats);
+    free(samples);
+
+    return time_stats.median;
+}
+
+/**
+ * @brief Compare configurations by trial time.
+ *
+ * @param a A configuration
+ * @param b Another configuration
+ * @return int Negative, zero or positive as `qsort` wants
+ */
+static int tuning_compare(const void *a, const void *b) {
+    double ta = ((const struct tuning *) a)->time;
+    double tb = ((const struct tuning *) b)->time;
+
+    return (ta > tb) - (ta < tb);
+}
+
+/**
+ * @brief Search the fastest configuration by successive halving.
+ *
+ * Every exchange backend is tried, with and without lossless
+ * compression where it applies; lossy compression is left out since it
+ * changes the solution. Every round times surviving configurations over
+ * short solutions, keeps the fastest half of them and doubles trials
+ * for the next round, so that slow configurations are pruned early and
+ * close ones get measured more. Collective over the communicator.
+ *
+ * @param comm Communicator of processes sharing the matrix
+ * @param n Matrix order
+ * @param A Matrix to solve (significant on MASTER only)
+ * @param best Fastest configuration
+ */
+void tune_search(MPI_Comm comm, int n, double *A, struct tuning *best) {
+    struct tuning candidates[HALO_COUNT * 2];
+    int count = 0;
+    int trials = 1;
+    int me;
+
+    MPI_Comm_rank(comm, &me);
+    for (int b = 0; b < HALO_COUNT; b++) {
+        candidates[count].backend = b;
+        candidates[count++].compress = COMPRESS_NONE;
+        if (b == HALO_SENDRECV || b == HALO_SHM) {
+            candidates[count].backend = b;
+            candidates[count++].compress = COMPRESS_LOSSLESS;
+        }
+    }
+
+    for (int round = 1; count > 1; round++) {
+        for (int c = 0; c < count; c++) {
+            candidates[c].time = tune_trial(comm, n, A, &candidates[c], trials);
+        }
+        qsort(candidates, count, sizeof *candidates, tuning_compare);
+
+        if (me == MASTER) {
+            printf("Tuning round %d, %d trials of %d iterations:", round, trials, TUNE_ITERATIONS);
+            for (int c = 0; c < count; c++) {
+                printf(
+                    "%s %s/%s %.3f ms",
+                    c == 0? "": ",",
+                    HALO_NAMES[candidates[c].backend],
+                    COMPRESS_NAMES[candidates[c].compress],
+                    candidates[c].time * 1E3
+                );
+            }
+            printf("\n");
+            fflush(stdout);
+        }
+        count = (count + 1) / 2;
+        trials *= 2;
+    }
+
+    *best = candidates[0];
+}
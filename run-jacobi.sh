@@ -7,31 +7,6 @@ IFS=$'\n\t'
 #
 # define utility functions
 #
-reduce() {
-    local filename=$1
-    local dimension=$2
-
-    # extract from CSV file the line with $dimension as first value
-    # then cut away comma-separated columns from second one
-    # at last, sort values from lower to upper
-    local values=(`grep "^$dimension," $filename | cut -d "," -f 2 | sort`)
-
-    # put lower value in 2nd place
-    # and higher one in 3rd place
-    local temp=${values[1]}
-    values[1]=${values[0]}
-    values[0]=$temp
-
-    # create new file line
-    local line=$dimension,${values[@]}
-    #echo $line
-
-    # replace lines with DIMENSION
-    # and make them unique
-    echo "$(sed "s/^$dimension,.*/$line/" $filename | uniq)" > $filename
-    echo "$(tr " " "," < $filename)" > $filename
-}
-
 printresults() {
     local results=$1
 
@@ -176,64 +151,27 @@ if [[ $TYPE == "serial" ]]; then
     #
     # run jacobi-serial
     #
+    # every dimension is solved $MEASUREITERATIONS times
+    # within a single execution, doubling dimension each time
     RESULTFILE="${RESULTFILE}.csv"
     echo "\"Size\",\"TimeMedian\",\"TimeMin\",\"TimeMax\"" > ./data/$RESULTFILE
-    for (( I = 1; I <= $ITERATIONS; I++ )); do
-        echo "$DIMENSION x $DIMENSION matrix"
-        echo -e "\tBEGIN ITERATION $I FOR $DIMENSION x $DIMENSION MATRIX\n" >> $OUTPUT
-        for (( J = 0; J < $MEASUREITERATIONS; J++ )); do
-            # stuff
-            echo -e "\n\tEXECUTION $J\n" >> $OUTPUT
-            ./bin/$BINARY $DIMENSION ./data/$RESULTFILE $DEBUG >> $OUTPUT
-        done
-        reduce ./data/$RESULTFILE $DIMENSION
+    DIMENSIONS=$DIMENSION
+    for (( I = 2; I <= $ITERATIONS; I++ )); do
         let DIMENSION=$DIMENSION*2
-        echo -e "\n\t-----\n" >> $OUTPUT
+        DIMENSIONS="$DIMENSIONS,$DIMENSION"
     done
+    echo "$DIMENSIONS matrices"
+    echo -e "\tBEGIN EXECUTION FOR $DIMENSIONS MATRICES\n" >> $OUTPUT
+    ./bin/$BINARY -r $MEASUREITERATIONS $DIMENSIONS ./data/$RESULTFILE $DEBUG >> $OUTPUT
+    echo -e "\n\t-----\n" >> $OUTPUT
 elif [[ $TYPE == "parallel" ]]; then
     WEAK_EXT="-w.csv"
     STRONG_EXT="-s.csv"
 
     # consider doing a local test for strong and weak scaling
-    if (( $NPROC_MAX >= 8 )); then
+    if (( $NPROC_MAX >= 2 )); then
         echo -e "\nPerforming local scaling tests..." | tee -a $OUTPUT
-        ORIGINAL_DIM=$DIMENSION
-        HEADER="\"Processors\",\"TimeMedian\",\"TimeMin\",\"TimeMax\""
-
-        # strong scaling local test
-        echo -e "\nLocal strong scaling test..." | tee -a $OUTPUT
-        echo "Starting dimension: $DIMENSION" | tee -a $OUTPUT
-        # increase dimension to maxiumu value first
-        for (( $NPROC = 2; $NPROC <= $NPROC_MAX; $NPROC = $NPROC * 2 )); do
-            let DIMENSION=$DIMENSION*2
-        done
-        MAX_DIM=$DIMENSION
-
-        echo $HEADER > ./data/$RESULTFILE"-l$STRONG_EXT"
-        for (( $NPROC = 2; $NPROC <= $NPROC_MAX; $NPROC = $NPROC * 2 )); do
-            for (( J = 0; J < $MEASUREITERATIONS; J++ )); do
-                mpiexec -np $NPROC --use-hwthread-cpus ./bin/$BINARY $DIMENSION $RESULTFILE"-l$STRONG_EXT" $DEBUG >> $OUTPUT
-            done
-            reduce ./data/$RESULTFILE"-l$STRONG_EXT" $NPROC
-        done
-
-        # weak scaling  local test
-        echo -e "\nLocal weak scaling test..." | tee -a $OUTPUT
-        echo "Starting dimension: $DIMENSION" | tee -a $OUTPUT
-        DIMENSION=$ORIGINAL_DIM
-        echo $HEADER > ./data/$RESULTFILE"-l$WEAK_EXT"
-        for (( $NPROC = 2; $NPROC <= $NPROC_MAX; $NPROC = $NPROC * 2 )); do
-            for (( J = 0; J < $MEASUREITERATIONS; J++ )); do
-                mpiexec -np $NPROC --use-hwthread-cpus ./bin/$BINARY $DIMENSION $RESULTFILE"-l$WEAK_EXT" $DEBUG >> $OUTPUT
-            done
-            reduce ./data/$RESULTFILE"-l$WEAK_EXT" $NPROC
-            let DIMENSION=$DIMENSION*2
-        done
-        DIMENSION=$ORIGINAL_DIM
-
-        # pause for debug purposes
-        echo -e "Press ENTER to continue..."
-        read KB_INPUT
+        ./scale-jacobi.sh -d $DIMENSION -n $NPROC_MAX -r $MEASUREITERATIONS -o ./data/${RESULTFILE%-parallel}
     else
         echo -e "\nNot enough cores ($NPROC_MAX) to perform local tests." | tee -a $OUTPUT
     fi
@@ -311,7 +249,7 @@ elif [[ $TYPE == "parallel" ]]; then
 
     # set results files header
     echo -e "\nSetting results file headers..." | tee -a $OUTPUT
-    HEADER="\"Processors\",\"TimeMedian\",\"TimeMin\",\"TimeMax\""
+    HEADER="\"Processors\",\"TimeMedian\",\"TimeMin\",\"TimeMax\",\"Size\""
     echo "Sending results files to MASTER..." | tee -a $OUTPUT
     REMOTE_COMMAND="echo \"${HEADER}\" > ./${RESULTFILE}${STRONG_EXT}"
     ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND &
@@ -346,29 +284,14 @@ elif [[ $TYPE == "parallel" ]]; then
             echo "Iteration $I of $BINARY, strong scaling" | tee -a $OUTPUT
             REMOTE_COMMAND="sudo -u $USERNAME mpiexec -np $NPROC --use-hwthread-cpus"
             REMOTE_COMMAND="${REMOTE_COMMAND} --hostfile /home/$USERNAME/$HOSTFILE"
-            REMOTE_COMMAND="${REMOTE_COMMAND} /home/$USERNAME/$BINARY $DIMENSION"
+            # the same dimension is solved few times to get estimation
+            REMOTE_COMMAND="${REMOTE_COMMAND} /home/$USERNAME/$BINARY"
+            REMOTE_COMMAND="${REMOTE_COMMAND} -r $MEASUREITERATIONS $DIMENSION"
             REMOTE_COMMAND="${REMOTE_COMMAND} /home/$USERNAME/${RESULTFILE}${STRONG_EXT}"
             echo "Executing $REMOTE_COMMAND" >> $OUTPUT
             SSH="ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND"
-            echo "Executing $SSH $MEASUREITERATIONS times" >> $OUTPUT
-            # run the same command few times to get estimation
-            for (( J = 0; J < $MEASUREITERATIONS; J++ )); do
-                sleep 1
-                eval $SSH
-                sleep 1
-            done
-
-            # reduce results at every iteration
-            # download, reduce, upload
-            # stupid but quick and effective right now
-            echo "Reducing results file for strong scaling..." | tee -a $OUTPUT
-            REMOTE_COMMAND="sudo mv /home/$USERNAME/${RESULTFILE}${STRONG_EXT} ."
-            ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND
-            scp -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP:$RESULTFILE"$STRONG_EXT" ./data/
-            reduce ./data/$RESULTFILE"$STRONG_EXT" $NPROC
-            scp -i ./scripts/key/$PEM_KEY ./data/$RESULTFILE"$STRONG_EXT" $ROOT@$MASTER_IP:
-            REMOTE_COMMAND="sudo mv ./${RESULTFILE}${STRONG_EXT} /home/$USERNAME/"
-            ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND
+            echo "Executing $SSH" >> $OUTPUT
+            eval $SSH
 
             # it's strong scaling, so doubling nproc
             let NPROC=$NPROC*2
@@ -392,29 +315,14 @@ elif [[ $TYPE == "parallel" ]]; then
             echo "Iteration $I of $BINARY, weak scaling"
             REMOTE_COMMAND="sudo -u $USERNAME mpiexec -np $NPROC --use-hwthread-cpus"
             REMOTE_COMMAND="${REMOTE_COMMAND} --hostfile /home/$USERNAME/$HOSTFILE"
-            REMOTE_COMMAND="${REMOTE_COMMAND} /home/$USERNAME/$BINARY $DIMENSION"
+            # the same dimension is solved few times to get estimation
+            REMOTE_COMMAND="${REMOTE_COMMAND} /home/$USERNAME/$BINARY"
+            REMOTE_COMMAND="${REMOTE_COMMAND} -r $MEASUREITERATIONS $DIMENSION"
             REMOTE_COMMAND="${REMOTE_COMMAND} /home/$USERNAME/${RESULTFILE}${WEAK_EXT}"
             echo "Executing $REMOTE_COMMAND" >> $OUTPUT
             SSH="ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND"
-            echo "Executing $SSH $MEASUREITERATIONS times" >> $OUTPUT
-            # run the same command few times to get estimation
-            for (( J = 0; J < $MEASUREITERATIONS; J++ )); do
-                sleep 1
-                eval $SSH
-                sleep 1
-            done
-
-            # reduce results at every iteration
-            # download, reduce, upload
-            # stupid but quick and effective right now
-            echo "Reducing results for weak scaling..." | tee -a $OUTPUT
-            REMOTE_COMMAND="sudo mv /home/$USERNAME/${RESULTFILE}${WEAK_EXT} ."
-            ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND
-            scp -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP:$RESULTFILE"$WEAK_EXT" ./data/
-            reduce ./data/$RESULTFILE"$WEAK_EXT" $NPROC
-            scp -i ./scripts/key/$PEM_KEY ./data/$RESULTFILE"$WEAK_EXT" $ROOT@$MASTER_IP:
-            REMOTE_COMMAND="sudo mv ./${RESULTFILE}${WEAK_EXT} /home/$USERNAME/"
-            ssh -i ./scripts/key/$PEM_KEY $ROOT@$MASTER_IP $REMOTE_COMMAND
+            echo "Executing $SSH" >> $OUTPUT
+            eval $SSH
 
             # it's weak scaling, so doubling both nproc and input dimension
             let NPROC=$NPROC*2
@@ -443,10 +351,12 @@ if (( $PRINT == 1 )); then
         echo "Local $TYPE results:"
         printresults ./data/$RESULTFILE
     elif [[ $TYPE == "parallel" ]]; then
-        if (( $NPROC_MAX >= 8 )); then
+        if (( $NPROC_MAX >= 2 )); then
             echo "Local $TYPE results:"
             printresults ./data/$RESULTFILE"-l$STRONG_EXT"
+            printresults ./data/$RESULTFILE"-l-s-metrics.csv"
             printresults ./data/$RESULTFILE"-l$WEAK_EXT"
+            printresults ./data/$RESULTFILE"-l-w-metrics.csv"
         fi
         echo "Remote $TYPE results:"
         printresults ./data/$RESULTFILE"$STRONG_EXT"
@@ -464,11 +374,13 @@ else
         echo -e "\n-----" >> $GPTLOG
         echo "Plot saved!" | tee -a $OUTPUT
     elif [[ $TYPE == "parallel" ]]; then
-        if (( $NPROC_MAX >= 8 )); then
+        if (( $NPROC_MAX >= 2 )); then
             # process local scaling tests results
             gnuplot -c $RESULTPLOT ./data/$RESULTFILE"-l$WEAK_EXT" $TYPE" weak scaling" 2>> $GPTLOG
             echo "-----" >> $GPTLOG
             gnuplot -c $RESULTPLOT ./data/$RESULTFILE"-l$STRONG_EXT" $TYPE" strong scaling" 2>> $GPTLOG
+            echo "-----" >> $GPTLOG
+            gnuplot -c $RESULTPLOT ./data/$RESULTFILE"-l-s-metrics.csv" $TYPE" efficiency" 2>> $GPTLOG
             echo -e "\n-----" >> $GPTLOG
         fi
 
@@ -0,0 +1,204 @@
+#!/bin/bash
+
+# strict mode
+set -euo pipefail
+IFS=$'\n\t'
+
+#
+# define utility functions
+#
+median() {
+    local filename=$1
+    local key=$2
+
+    # extract median time of line with $key as first value
+    grep "^$key," $filename | tail -n 1 | cut -d "," -f 2
+}
+
+metrics() {
+    local time_serial=$1
+    local time_parallel=$2
+    local nproc=$3
+
+    # speedup, parallel efficiency and Karp-Flatt metric
+    awk -v ts="$time_serial" -v tp="$time_parallel" -v p="$nproc" 'BEGIN {
+        s = ts / tp
+        e = s / p
+        kf = (p > 1)? (1 / s - 1 / p) / (1 - 1 / p): 0
+        printf "%f,%f,%f", s, e, kf
+    }'
+}
+
+runparallel() {
+    local nproc=$1
+    local dimension=$2
+    local results=$3
+    local flags=()
+
+    # pin one rank per core unless cores are not enough
+    if (( $nproc > $CORES )); then
+        flags=(--oversubscribe --bind-to none)
+        echo "Warning: $nproc ranks over $CORES cores, timings are oversubscribed!" | tee -a $OUTPUT
+    else
+        flags=(--bind-to core --map-by core --report-bindings)
+    fi
+    mpiexec -np $nproc "${flags[@]}" ${EXTRA_FLAGS[@]+"${EXTRA_FLAGS[@]}"} \
+        ./bin/jacobi-parallel -r $REPETITIONS -w $WARMUP $dimension $results >> $OUTPUT 2>&1
+}
+
+#
+# check for input parameters
+#
+TIME=$(date "+%Y.%m.%d-%H:%M:%S")
+VERSION=$(cat ./VERSION)
+CORES=$(lscpu -p=Core,Socket 2> /dev/null | grep -v "^#" | sort -u | wc -l)
+if (( $CORES == 0 )); then
+    CORES=$(nproc)
+fi
+NPROC_MAX=$CORES
+REPETITIONS=5
+WARMUP=1
+DIMENSION=""
+PREFIX=./data/results
+IFS=' ' read -r -a EXTRA_FLAGS <<< "${MPIEXEC_FLAGS-}"
+while [[ "${1-0}" =~ ^- && ! "${1-0}" == "--" ]]; do
+    case $1 in
+        ( -d | --dimension )
+            shift;
+            DIMENSION=$1
+            ;;
+        ( -n | --nproc )
+            shift;
+            NPROC_MAX=$1
+            ;;
+        ( -r | --repetitions )
+            shift;
+            REPETITIONS=$1
+            ;;
+        ( -w | --warmup )
+            shift;
+            WARMUP=$1
+            ;;
+        ( -o | --output )
+            shift;
+            PREFIX=$1
+            ;;
+        ( -v | --version )
+            echo $VERSION
+            exit
+            ;;
+        ( -h | --help)
+            echo "Jacobi MPI $VERSION"
+            echo
+            echo "Runs local strong and weak scaling tests of jacobi-parallel against"
+            echo "jacobi-serial, with no user interaction, pinning every rank to a core."
+            echo "Strong scaling keeps dimension fixed; weak scaling grows dimension"
+            echo "with the square root of ranks, so that work per rank stays fixed."
+            echo
+            echo "Usage: $0 --dimension <dimension> [--nproc <ranks>] [--repetitions <r>] [--warmup <w>] [--output <prefix>]"
+            echo
+            echo "--dimension or -d: matrix dimension (weak scaling dimension for 1 rank)"
+            echo "--nproc or -n: maximum number of ranks (default: $NPROC_MAX physical cores)"
+            echo "--repetitions or -r: timed solutions for every run (default: $REPETITIONS)"
+            echo "--warmup or -w: untimed solutions for every run (default: $WARMUP)"
+            echo "--output or -o: results files prefix (default: $PREFIX)"
+            echo "--version or -v: print Jacobi MPI version"
+            echo "--help or -h: print this program guide"
+            echo
+            echo "Extra mpiexec flags can be given in MPIEXEC_FLAGS environment variable."
+            exit
+            ;;
+        ( * )
+            echo "Invalid parameter specified!"
+            exit 1
+            ;;
+    esac;
+    shift;
+done
+if [[ -z $DIMENSION ]]; then
+    echo "-d parameter is mandatory!"
+    exit 1
+fi
+
+#
+# build binaries if they don't already exist
+#
+if [[ ! -e ./log ]]; then
+    mkdir log
+fi
+OUTPUT=./log/scale-jacobi.log
+echo -e "\n\t#####\n" >> $OUTPUT
+echo "[$TIME] Running Jacobi MPI $VERSION, local scaling" >> $OUTPUT
+if [[ ! -e ./bin/jacobi-serial || ! -e ./bin/jacobi-parallel ]]; then
+    echo "Building binaries..." | tee -a $OUTPUT
+    mkdir -p bin
+    make jacobiutils jacobi-serial jacobi-parallel >> $OUTPUT
+fi
+
+# ranks are doubled from 2 (jacobi-parallel minimum) up to maximum
+NPROCS=()
+for (( NPROC = 2; NPROC <= $NPROC_MAX; NPROC = NPROC * 2 )); do
+    NPROCS+=($NPROC)
+done
+if (( ${#NPROCS[@]} == 0 || ${NPROCS[-1]} != $NPROC_MAX )); then
+    NPROCS+=($NPROC_MAX)
+fi
+echo "Local scaling over ${NPROCS[*]} ranks ($CORES physical cores)" | tee -a $OUTPUT
+
+HEADER="\"Processors\",\"TimeMedian\",\"TimeMin\",\"TimeMax\",\"Size\""
+METRICS_HEADER="\"Processors\",\"Speedup\",\"Efficiency\",\"KarpFlatt\",\"Oversubscribed\""
+SERIAL="${PREFIX}-serial-l.csv"
+STRONG="${PREFIX}-parallel-l-s.csv"
+WEAK="${PREFIX}-parallel-l-w.csv"
+STRONG_METRICS="${PREFIX}-parallel-l-s-metrics.csv"
+WEAK_METRICS="${PREFIX}-parallel-l-w-metrics.csv"
+
+#
+# serial reference time
+#
+echo -e "\nSerial reference for $DIMENSION x $DIMENSION matrix..." | tee -a $OUTPUT
+echo "\"Size\",\"TimeMedian\",\"TimeMin\",\"TimeMax\"" > $SERIAL
+taskset -c 0 ./bin/jacobi-serial -r $REPETITIONS -w $WARMUP $DIMENSION $SERIAL >> $OUTPUT
+TIME_SERIAL=$(median $SERIAL $DIMENSION)
+echo "Serial time: $TIME_SERIAL s" | tee -a $OUTPUT
+
+#
+# strong scaling, fixed dimension
+#
+echo -e "\nLocal strong scaling test for $DIMENSION x $DIMENSION matrix..." | tee -a $OUTPUT
+echo $HEADER > $STRONG
+echo $METRICS_HEADER > $STRONG_METRICS
+for NPROC in ${NPROCS[@]}; do
+    echo "$NPROC ranks" | tee -a $OUTPUT
+    runparallel $NPROC $DIMENSION $STRONG
+    echo "$NPROC,$(metrics $TIME_SERIAL $(median $STRONG $NPROC) $NPROC),$(( $NPROC > $CORES ))" >> $STRONG_METRICS
+done
+
+#
+# weak scaling, fixed work per rank
+#
+echo -e "\nLocal weak scaling test from $DIMENSION x $DIMENSION matrix..." | tee -a $OUTPUT
+echo $HEADER > $WEAK
+echo $METRICS_HEADER > $WEAK_METRICS
+for NPROC in ${NPROCS[@]}; do
+    WEAK_DIMENSION=$(awk -v d=$DIMENSION -v p=$NPROC 'BEGIN { printf "%d", d * sqrt(p) + 0.5 }')
+    echo "$NPROC ranks, $WEAK_DIMENSION x $WEAK_DIMENSION matrix" | tee -a $OUTPUT
+    runparallel $NPROC $WEAK_DIMENSION $WEAK
+    # scaled speedup is p times weak efficiency
+    echo "$NPROC,$(metrics $(awk -v t=$TIME_SERIAL -v p=$NPROC 'BEGIN { printf "%f", t * p }') $(median $WEAK $NPROC) $NPROC),$(( $NPROC > $CORES ))" >> $WEAK_METRICS
+done
+echo -e "\n\t#####" >> $OUTPUT
+
+#
+# print results
+#
+echo -e "\nStrong scaling:"
+echo "$(tr "," "\t" < $STRONG)"
+echo "$(tr "," "\t" < $STRONG_METRICS)"
+echo -e "\nWeak scaling:"
+echo "$(tr "," "\t" < $WEAK)"
+echo "$(tr "," "\t" < $WEAK_METRICS)"
+echo
+echo "Plot them with:"
+echo "gnuplot -c ./src/results.plt $STRONG \"parallel strong scaling\""
+echo "gnuplot -c ./src/results.plt $STRONG_METRICS \"parallel efficiency\""
@@ -0,0 +1,373 @@
+/**
+ * @file jacobi-bench.c
+ * @ingroup runnable
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Microbenchmarks of utility library routines.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+/**
+ * @brief Use timespec definition from POSIX.
+ *
+ * Use `timespec` definition from POSIX.
+ */
+#define _XOPEN_SOURCE 700
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "matrixutils.h"
+#include "jacobi.h"
+#include "perfcounters.h"
+#include "stats.h"
+#include "misc.h"
+
+/**
+ * @brief Minimum double precision floating point number to be generated.
+ */
+extern const double LOWER_BOUND;
+/**
+ * @brief Maximum double precision floating point number to be generated.
+ */
+extern const double UPPER_BOUND;
+
+/**
+ * @brief Default results file.
+ */
+#define BENCH_OUTPUT "./data/results-bench.csv"
+/**
+ * @brief Untimed calls before measuring.
+ */
+#define WARMUP_CALLS 2
+/**
+ * @brief Minimum number of timed samples.
+ */
+#define MIN_SAMPLES 5
+/**
+ * @brief Maximum number of timed samples.
+ */
+#define MAX_SAMPLES 101
+/**
+ * @brief Latest samples left out when checking for stability.
+ */
+#define STABLE_WINDOW 3
+/**
+ * @brief Relative median drift below which samples are stable.
+ */
+#define STABLE_TOLERANCE 0.01
+/**
+ * @brief Minimum duration of a sample, short kernels are batched.
+ */
+#define MIN_SAMPLE_TIME 1E-3
+/**
+ * @brief Time budget for a kernel at a given size, in seconds.
+ */
+#define KERNEL_BUDGET 3.0
+/**
+ * @brief Vectors of multi-vector product.
+ */
+#define MULTI_VECTORS 4
+
+/**
+ * @brief Benchmarked library routines.
+ */
+enum bench_kernel {
+    BENCH_SWEEP,     /**< jacobi_iteration */
+    BENCH_RESIDUAL,  /**< convergence_check_g */
+    BENCH_REPLACE,   /**< replace_partial */
+    BENCH_COPY,      /**< copy_matrix_array */
+    BENCH_TRANSPOSE, /**< transpose_matrix_array */
+    BENCH_MATVEC,    /**< prod_mat_vett */
+    BENCH_MULTI_MATVEC, /**< prod_mat_multi_vett */
+    BENCH_COUNT      /**< Number of routines */
+};
+
+/**
+ * @brief Routine names as written in results file.
+ */
+static const char *BENCH_NAMES[BENCH_COUNT] = {
+    "jacobi_iteration",
+    "convergence_check_g",
+    "replace_partial",
+    "copy_matrix_array",
+    "transpose_matrix_array",
+    "prod_mat_vett",
+    "prod_mat_multi_vett"
+};
+
+/**
+ * @brief Minimum memory traffic per matrix element of every routine.
+ *
+ * Vectors of products stay in cache, only the matrix streams.
+ */
+static const double BENCH_BYTES[BENCH_COUNT] = {
+    24.0, 16.0, 24.0, 24.0, 24.0, 8.0, 8.0
+};
+
+/**
+ * @brief Default matrix orders of size sweep.
+ */
+static const int BENCH_SIZES[] = { 256, 512, 1024, 2048, 4096 };
+
+/**
+ * @brief Operands of benchmarked routines.
+ */
+struct bench_data {
+    int n;     /**< Matrix order */
+    double *A; /**< First matrix */
+    double *B; /**< Second matrix */
+    double *v; /**< Input vector */
+    double *r; /**< Output vector */
+    double *w; /**< Output vectors of multi-vector product */
+};
+
+/**
+ * @brief Monotonic time in seconds.
+ *
+ * @return double Seconds from an arbitrary point in time
+ */
+static double now(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1E9;
+}
+
+/**
+ * @brief Call a routine once.
+ *
+ * @param kernel Routine to call
+ * @param d Operands
+ * @return double A value depending on the result, to keep it alive
+ */
+static double call_kernel(enum bench_kernel kernel, struct bench_data *d) {
+    int n = d->n;
+
+    switch (kernel) {
+        case BENCH_SWEEP:
+            jacobi_iteration(d->A, d->B, n, n);
+            return d->B[n + 1];
+        case BENCH_RESIDUAL:
+            return convergence_check_g(d->A, d->B, n, n);
+        case BENCH_REPLACE:
+            replace_partial(d->B, d->A, n, n, (n - 1) * n, 0);
+            return d->B[n + 1];
+        case BENCH_COPY:
+            copy_matrix_array(d->A, d->B, n, n);
+            return d->B[n - 1];
+        case BENCH_TRANSPOSE:
+            transpose_matrix_array(d->A, d->B, n, n);
+            return d->B[n - 1];
+        case BENCH_MATVEC:
+            prod_mat_vett(d->r, d->A, n, n, d->v);
+            return d->r[n - 1];
+        case BENCH_MULTI_MATVEC:
+            // first rows of second matrix are input vectors
+            prod_mat_multi_vett(d->w, d->A, n, n, d->B, MULTI_VECTORS);
+            return d->w[n - 1];
+        default:
+            return 0.0;
+    }
+}
+
+/**
+ * @brief Benchmark a routine until its timings are stable.
+ *
+ * After warmup, calls are batched so that every sample lasts at least
+ * MIN_SAMPLE_TIME; sampling stops when the median settles, when
+ * MAX_SAMPLES is reached or when KERNEL_BUDGET is exhausted.
+ *
+ * @param kernel Routine to benchmark
+ * @param d Operands
+ * @param stats Time per call statistics
+ * @param sink Accumulator of routine results
+ */
+static void bench_kernel(
+    enum bench_kernel kernel,
+    struct bench_data *d,
+    struct time_stats *stats,
+    double *sink
+) {
+    double samples[MAX_SAMPLES];
+    int count = 0;
+    int batch = 1;
+    double start;
+    double elapsed;
+    double budget_start;
+
+    for (int i = 0; i < WARMUP_CALLS; i++) {
+        *sink += call_kernel(kernel, d);
+    }
+
+    // calibrate batch size
+    do {
+        start = now();
+        for (int i = 0; i < batch; i++) {
+            *sink += call_kernel(kernel, d);
+        }
+        elapsed = now() - start;
+        if (elapsed < MIN_SAMPLE_TIME) {
+            batch *= 2;
+        }
+    } while (elapsed < MIN_SAMPLE_TIME);
+
+    budget_start = now();
+    do {
+        start = now();
+        for (int i = 0; i < batch; i++) {
+            *sink += call_kernel(kernel, d);
+        }
+        samples[count++] = (now() - start) / batch;
+    } while (
+        count < MAX_SAMPLES &&
+        now() - budget_start < KERNEL_BUDGET &&
+        (count < MIN_SAMPLES ||
+            !times_stable(samples, count, STABLE_WINDOW, STABLE_TOLERANCE))
+    );
+
+    summarize_times(samples, count, stats);
+}
+
+/**
+ * @brief The main function of library microbenchmarks.
+ *
+ * @param argc Count of command-line parameters
+ * @param argv Command-line parameters
+ * @return int Return value indicating whether program execution succeded
+ */
+int main(int argc, char **argv) {
+    char *output_file = BENCH_OUTPUT;
+    int *sizes;
+    int size_count;
+    struct bench_data d;
+    struct time_stats stats;
+    double sink = 0.0;
+    double ceiling;
+    double ceiling_threads;
+    int threads_max;
+    FILE *results;
+
+    printf("Running %s...\n\n\v", argv[0]);
+    fflush(stdout);
+
+    // reading results file and matrix orders from command line
+    if (argc > 1) {
+        output_file = argv[1];
+    }
+    if (argc > 2) {
+        size_count = argc - 2;
+        sizes = malloc(size_count * sizeof *sizes);
+        for (int i = 0; i < size_count; i++) {
+            sizes[i] = atoi(argv[i + 2]);
+        }
+    }
+    else {
+        size_count = sizeof BENCH_SIZES / sizeof *BENCH_SIZES;
+        sizes = malloc(size_count * sizeof *sizes);
+        memcpy(sizes, BENCH_SIZES, sizeof BENCH_SIZES);
+    }
+
+    results = fopen(output_file, "w");
+    if (results == NULL) {
+        fprintf(stderr, "\aCannot open %s!\n", output_file);
+        free(sizes);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(
+        results,
+        "\"Kernel\",\"Size\",\"TimeMedian\",\"TimeMin\",\"TimeMax\","
+        "\"TimeP05\",\"TimeP95\",\"Samples\",\"Bandwidth\",\"StreamFraction\"\n"
+    );
+
+    // bandwidth is compared against STREAM triad of as many threads
+    // as the kernel runs on, a single one but for large products
+    threads_max = matvec_threads(INT_MAX, 1);
+    ceiling = stream_triad_bandwidth(1);
+    ceiling_threads = (threads_max > 1)? stream_triad_bandwidth(threads_max): ceiling;
+    printf("STREAM triad bandwidth: %.3f GB/s with 1 thread", ceiling / 1E9);
+    if (threads_max > 1) {
+        printf(", %.3f GB/s with %d threads", ceiling_threads / 1E9, threads_max);
+    }
+    printf("\n\n");
+    printf(
+        "%-24s %6s %12s %12s %12s %12s %8s %8s\n",
+        "Kernel", "Size", "Median (ms)", "Min (ms)", "P95 (ms)", "GB/s", "STREAM", "Samples"
+    );
+    for (int s = 0; s < size_count; s++) {
+        d.n = sizes[s];
+        d.A = malloc((size_t) d.n * d.n * sizeof *d.A);
+        d.B = malloc((size_t) d.n * d.n * sizeof *d.B);
+        d.v = malloc(d.n * sizeof *d.v);
+        d.r = malloc(d.n * sizeof *d.r);
+        d.w = malloc(d.n * MULTI_VECTORS * sizeof *d.w);
+        if (d.A == NULL || d.B == NULL || d.v == NULL || d.r == NULL || d.w == NULL) {
+            fprintf(stderr, "\aCannot allocate %dx%d matrices!\n", d.n, d.n);
+            exit(EXIT_FAILURE);
+        }
+        generate_matrix_array(d.A, d.n, d.n, LOWER_BOUND, UPPER_BOUND, SEED);
+        copy_matrix_array(d.A, d.B, d.n, d.n);
+        generate_matrix_array(d.v, 1, d.n, LOWER_BOUND, UPPER_BOUND, SEED);
+
+        for (int k = 0; k < BENCH_COUNT; k++) {
+            double bandwidth;
+            double stream = ceiling;
+            int threads = 1;
+
+            if (k == BENCH_MATVEC || k == BENCH_MULTI_MATVEC) {
+                threads = matvec_threads(d.n, d.n);
+            }
+            if (threads == threads_max) {
+                stream = ceiling_threads;
+            } else if (threads > 1) {
+                stream = stream_triad_bandwidth(threads);
+            }
+            bench_kernel(k, &d, &stats, &sink);
+            bandwidth = BENCH_BYTES[k] * d.n * (double) d.n / stats.median;
+            printf(
+                "%-24s %6d %12.4f %12.4f %12.4f %12.3f %7.0f%% %8d\n",
+                BENCH_NAMES[k],
+                d.n,
+                stats.median * 1E3,
+                stats.min * 1E3,
+                stats.p95 * 1E3,
+                bandwidth / 1E9,
+                stream > 0.0? bandwidth / stream * 100: 0.0,
+                stats.samples
+            );
+            fflush(stdout);
+            fprintf(
+                results,
+                "\"%s\",%d,%f,%f,%f,%f,%f,%d,%f,%f\n",
+                BENCH_NAMES[k],
+                d.n,
+                stats.median,
+                stats.min,
+                stats.max,
+                stats.p05,
+                stats.p95,
+                stats.samples,
+                bandwidth / 1E9,
+                stream > 0.0? bandwidth / stream: 0.0
+            );
+        }
+
+        free(d.A);
+        free(d.B);
+        free(d.v);
+        free(d.r);
+        free(d.w);
+    }
+    fclose(results);
+    free(sizes);
+
+    printf("\nResults written in %s (checksum %g)\n", output_file, sink);
+    printf("\n\v%s terminated succesfully!\n", argv[0]);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file jacobi-model.c
+ * @ingroup runnable
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Communication performance model and scaling predictor.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+/**
+ * @brief Use getopt definitions from POSIX.
+ *
+ * Use `getopt` definitions from POSIX.
+ */
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mpi.h"
+#include "jacobi.h"
+#include "mpiutils.h"
+#include "perfmodel.h"
+#include "regress.h"
+
+/**
+ * @brief Default measured strong scaling results.
+ */
+#define STRONG_RESULTS "./data/results-parallel-s.csv"
+/**
+ * @brief Default measured weak scaling results.
+ */
+#define WEAK_RESULTS "./data/results-parallel-w.csv"
+/**
+ * @brief Default largest number of processes to predict.
+ */
+#define MODEL_RANKS 32
+/**
+ * @brief Growth factor of ping-pong message sizes.
+ */
+#define MESSAGE_GROWTH 4
+
+/**
+ * @brief Print and write predicted times of a scaling curve.
+ *
+ * Strong scaling keeps matrix order, weak scaling grows it as
+ * processes, as measured results in `data` were taken.
+ *
+ * @param m Model
+ * @param label Curve name
+ * @param order Matrix order with 1 process (strong) or 2 (weak)
+ * @param weak Whether to grow matrix order with processes
+ * @param ranks Largest number of processes
+ * @param iterations Iterations of every solution
+ * @param measured_file Measured results file
+ * @param output Predictions file, NULL for none
+ */
+static void predict_scaling(
+    struct perfmodel *m,
+    const char *label,
+    int order,
+    int weak,
+    int ranks,
+    int iterations,
+    char *measured_file,
+    FILE *output
+) {
+    double predicted;
+    double measured;
+    int n;
+
+    printf(
+        "%s scaling, n=%d%s, %d iterations, measured in %s\n",
+        label,
+        order,
+        weak? " over 2 processes": "",
+        iterations,
+        measured_file
+    );
+    printf(
+        "%10s %8s %14s %14s %10s\n",
+        "Processors", "Size", "Predicted (s)", "Measured (s)", "Ratio"
+    );
+    for (int p = weak? 2: 1; p <= ranks; p *= 2) {
+        n = weak? order / 2 * p: order;
+        if (n / p < 2) {
+            break;
+        }
+        predicted = perfmodel_solution(m, n, p, iterations);
+        if (baseline_median(measured_file, n, p, &measured) == 0) {
+            printf(
+                "%10d %8d %14.6f %14.6f %10.2f\n",
+                p, n, predicted, measured, predicted / measured
+            );
+        } else {
+            printf("%10d %8d %14.6f %14s %10s\n", p, n, predicted, "-", "-");
+            measured = -1.0;
+        }
+        if (output != NULL) {
+            fprintf(output, "%s,%d,%d,%f,", label, p, n, predicted);
+            if (measured >= 0.0) {
+                fprintf(output, "%f\n", measured);
+            } else {
+                fprintf(output, "\n");
+            }
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+/**
+ * @brief The main function of scaling predictor.
+ *
+ * Runs over 2 processes at least, which should be placed as slab
+ * neighbours of a real run would.
+ *
+ * @param argc Count of command-line parameters
+ * @param argv Command-line parameters
+ * @return int Return value indicating whether program execution succeded
+ */
+int main(int argc, char **argv) {
+    int nproc;
+    int me;
+    MPI_Comm COMM = MPI_COMM_WORLD;
+    struct perfmodel model;
+    int ranks = MODEL_RANKS;
+    int iterations = MAX_ITERATIONS;
+    char *strong_file = STRONG_RESULTS;
+    char *weak_file = WEAK_RESULTS;
+    char *output_file = NULL;
+    FILE *output = NULL;
+    int strong_order;
+    int weak_order;
+    int opt;
+    int message_count;
+    int *counts;
+    double *bytes;
+    double *seconds;
+    double reduction;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(COMM, &nproc);
+    MPI_Comm_rank(COMM, &me);
+
+    while ((opt = getopt(argc, argv, "p:i:s:w:")) != -1) {
+        switch (opt) {
+            case 'p':
+                ranks = atoi(optarg);
+                break;
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 's':
+                strong_file = optarg;
+                break;
+            case 'w':
+                weak_file = optarg;
+                break;
+            default:
+                ranks = 0;
+        }
+    }
+    if (argc - optind < 2 || ranks < 1 || iterations < 1 || nproc < 2 ||
+        (strong_order = atoi(argv[optind])) < 3 ||
+        (weak_order = atoi(argv[optind + 1])) < 3) {
+        if (me == MASTER) {
+            printf("\aInsufficient number of parameters!\n");
+            printf(
+                "Usage: mpiexec -np <2 or more> %s [-p <ranks>] [-i <iterations>] "
+                "[-s <strongResults>] [-w <weakResults>] "
+                "<strongOrder> <weakOrder> [<outputFileName>]\n",
+                argv[0]
+            );
+            printf("\t-p: largest number of processes to predict (default %d)\n", MODEL_RANKS);
+            printf("\t-i: iterations of every solution (default %d)\n", MAX_ITERATIONS);
+            printf("\t-s: measured strong scaling results (default %s)\n", STRONG_RESULTS);
+            printf("\t-w: measured weak scaling results (default %s)\n", WEAK_RESULTS);
+            printf("\tweak scaling order is the one over 2 processes, growing as them\n\n");
+            fflush(stdout);
+        }
+
+        MPI_Abort(COMM, EXIT_FAILURE);
+        exit(EXIT_FAILURE);
+    }
+    if (argc - optind > 2) {
+        output_file = argv[optind + 2];
+    }
+
+    if (me == MASTER) {
+        printf("Running %s over %d processes...\n\n\v", argv[0], nproc);
+        fflush(stdout);
+    }
+
+    // row-sized ping-pong between slab neighbours, up to
+    // the largest row to predict, calibrated as -a does
+    message_count = 0;
+    for (int c = 1; c < strong_order || c < weak_order / 2 * ranks; c *= MESSAGE_GROWTH) {
+        message_count++;
+    }
+    message_count++;
+    counts = malloc(message_count * sizeof *counts);
+    bytes = malloc(message_count * sizeof *bytes);
+    seconds = malloc(message_count * sizeof *seconds);
+    for (int i = 0, c = 1; i < message_count; i++, c *= MESSAGE_GROWTH) {
+        counts[i] = c;
+    }
+    counts[message_count - 1] = (strong_order > weak_order / 2 * ranks)?
+        strong_order: weak_order / 2 * ranks;
+    for (int i = 0; i < message_count; i++) {
+        bytes[i] = counts[i] * sizeof (double);
+    }
+    perfmodel_calibrate(&model, COMM, message_count, counts, seconds);
+    reduction = model.stage * perfmodel_stages(nproc);
+
+    if (me == MASTER) {
+        printf(
+            "Sweep: %.3f ns per cell alone, %.3f ns with %d processes sweeping\n",
+            model.cell * 1E9,
+            model.cell_busy * 1E9,
+            nproc
+        );
+        printf("Ping-pong between P%d and P%d:\n", MASTER, MASTER + 1);
+        for (int i = 0; i < message_count; i++) {
+            printf(
+                "%10d doubles: %10.3f us one way, %10.3f us as fitted\n",
+                counts[i],
+                seconds[i] * 1E6,
+                (model.latency + bytes[i] * model.byte) * 1E6
+            );
+        }
+        printf(
+            "Fitted latency: %.3f us, bandwidth: %.3f GB/s\n",
+            model.latency * 1E6,
+            (model.byte > 0.0)? 1E-9 / model.byte: 0.0
+        );
+        printf(
+            "MPI_Allreduce: %.3f us over %d processes, %.3f us per stage\n",
+            reduction * 1E6,
+            nproc,
+            model.stage * 1E6
+        );
+        printf("\n");
+        fflush(stdout);
+
+        if (output_file != NULL) {
+            output = fopen(output_file, "w");
+            if (output == NULL) {
+                fprintf(stderr, "\aCannot open %s!\n", output_file);
+            } else {
+                fprintf(output, "\"Scaling\",\"Processors\",\"Size\",\"Predicted\",\"Measured\"\n");
+            }
+        }
+        predict_scaling(&model, "Strong", strong_order, 0, ranks, iterations, strong_file, output);
+        predict_scaling(&model, "Weak", weak_order, 1, ranks, iterations, weak_file, output);
+        if (output != NULL) {
+            fclose(output);
+            printf("Predictions written in %s\n", output_file);
+        }
+        printf("\n\v%s terminated succesfully!\n", argv[0]);
+    }
+    free(counts);
+    free(bytes);
+    free(seconds);
+
+    MPI_Finalize();
+
+    return EXIT_SUCCESS;
+}
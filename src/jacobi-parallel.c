@@ -11,7 +11,7 @@
  */
 /**
  * @brief Use timespec definition from POSIX.
- * 
+ *
  * Use `timespec` definition from POSIX.
  */
 #define _XOPEN_SOURCE 700
@@ -25,11 +25,28 @@
 #include "matrixutils.h"
 #include "jacobi.h"
 #include "mpiutils.h"
+#include "compress.h"
+#include "csr.h"
+#include "dense.h"
+#include "farm.h"
+#include "halo.h"
+#include "phases.h"
+#include "perfmodel.h"
+#include "placement.h"
+#include "options.h"
+#include "perfcounters.h"
+#include "regress.h"
+#include "slab.h"
+#include "sparse.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "trace.h"
+#include "tune.h"
 #include "misc.h"
 
 /**
  * @brief How many milliseconds in a second.
- * 
+ *
  * How many milliseconds in a second.
  */
 extern const int MS_IN_S;
@@ -42,9 +59,272 @@ extern const double LOWER_BOUND;
  */
 extern const double UPPER_BOUND;
 
+/**
+ * @brief Sum hardware events and cells of every rank on MASTER.
+ *
+ * Kernel time is the one of slowest rank.
+ *
+ * @param local Counters of this rank
+ * @param total Counters of all ranks (meaningful on MASTER only)
+ * @param comm Communicator
+ */
+static void reduce_counters(
+    struct kernel_counters *local,
+    struct kernel_counters *total,
+    MPI_Comm comm
+) {
+    MPI_Reduce(
+        local->value, total->value,
+        KERNEL_COUNT * COUNTER_COUNT, MPI_UNSIGNED_LONG_LONG, MPI_SUM,
+        MASTER, comm
+    );
+    MPI_Reduce(
+        local->calls, total->calls,
+        KERNEL_COUNT, MPI_UNSIGNED_LONG_LONG, MPI_MAX,
+        MASTER, comm
+    );
+    MPI_Reduce(
+        local->cells, total->cells,
+        KERNEL_COUNT, MPI_DOUBLE, MPI_SUM,
+        MASTER, comm
+    );
+    MPI_Reduce(
+        local->seconds, total->seconds,
+        KERNEL_COUNT, MPI_DOUBLE, MPI_MAX,
+        MASTER, comm
+    );
+    MPI_Reduce(
+        local->available, total->available,
+        COUNTER_COUNT, MPI_INT, MPI_MIN,
+        MASTER, comm
+    );
+}
+
+/**
+ * @brief Exchanges timed to compare process rankings.
+ */
+static const int PROBE_ROUNDS = 100;
+
+/**
+ * @brief Print which process got every topology rank.
+ *
+ * @param world_me Rank of this process in MPI_COMM_WORLD
+ * @param topology Reordered communicator
+ */
+static void report_remap(int world_me, MPI_Comm topology) {
+    int nproc;
+    int me;
+    int moved = 0;
+    int *world_ranks = NULL;
+
+    MPI_Comm_size(topology, &nproc);
+    MPI_Comm_rank(topology, &me);
+    if (me == MASTER) {
+        world_ranks = malloc(nproc * sizeof *world_ranks);
+    }
+    MPI_Gather(&world_me, 1, MPI_INT, world_ranks, 1, MPI_INT, MASTER, topology);
+
+    if (me == MASTER) {
+        printf("Topology ranks (topology rank <- world rank):");
+        for (int p = 0; p < nproc; p++) {
+            printf(" %d<-%d", p, world_ranks[p]);
+            moved += world_ranks[p] != p;
+        }
+        printf("\n%d of %d processes got a new rank\n\n", moved, nproc);
+        fflush(stdout);
+        free(world_ranks);
+    }
+}
+
+/**
+ * @brief Print neighbour links by locality and which host got every rank.
+ *
+ * @param comm Communicator ranked by locality
+ * @param launched Neighbour links as launched
+ * @param placed Neighbour links as placed
+ */
+static void report_placement(
+    MPI_Comm comm,
+    struct placement_links *launched,
+    struct placement_links *placed
+) {
+    int nproc;
+    int me;
+    int length;
+    int first = 0;
+    char host[MPI_MAX_PROCESSOR_NAME];
+    char *hosts = NULL;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    if (me == MASTER) {
+        hosts = malloc((size_t) nproc * MPI_MAX_PROCESSOR_NAME);
+    }
+    MPI_Get_processor_name(host, &length);
+    MPI_Gather(
+        host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+        hosts, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+        MASTER, comm
+    );
+
+    if (me == MASTER) {
+        printf("Rank placement over %d nodes:", placed->nodes);
+        for (int p = 1; p <= nproc; p++) {
+            if (p == nproc || strcmp(&hosts[p * MPI_MAX_PROCESSOR_NAME],
+                                     &hosts[first * MPI_MAX_PROCESSOR_NAME]) != 0) {
+                printf(" %s %d-%d", &hosts[first * MPI_MAX_PROCESSOR_NAME], first, p - 1);
+                first = p;
+            }
+        }
+        printf("\n");
+        printf(
+            "Neighbour links within a node: %d of %d as launched, %d as placed\n",
+            launched->on_node,
+            launched->links,
+            placed->on_node
+        );
+        printf(
+            "Neighbour links within a socket: %d of %d as launched, %d as placed\n",
+            launched->on_socket,
+            launched->links,
+            placed->on_socket
+        );
+        printf("\n");
+        fflush(stdout);
+        free(hosts);
+    }
+}
+
+/**
+ * @brief Check that options given together make sense.
+ *
+ * Compression applies to rows sent as messages, dense and sparse
+ * systems exchange solution with no ghost rows or hardware counters,
+ * only sparse ones may be read from file; task farm groups run at
+ * once, and some MPI libraries name RMA window files by communicator
+ * id, which disjoint groups share; active-set solution is serial only.
+ *
+ * @param opts Parsed options
+ * @param halo Ghost rows exchange backend
+ * @param compress Ghost rows compression mode
+ * @param problem Problem to solve
+ * @return const char* What is wrong, NULL if options are consistent
+ */
+static const char *check_options(struct options *opts, int halo, int compress, int problem) {
+    if (compress != COMPRESS_NONE && halo != HALO_SENDRECV && halo != HALO_SHM) {
+        return "-z works with sendrecv or shm exchange only";
+    }
+    if (problem == JACOBI_ACTIVE) {
+        return "-m active works on jacobi-serial only";
+    }
+    if (problem != JACOBI_GRID &&
+        (opts->counters || opts->halo != NULL || opts->compress != NULL ||
+         opts->snapshot_prefix != NULL || opts->autotune || opts->autoranks)) {
+        return "-m dense and sparse take no -c, -x, -z, -S, -A or -a";
+    }
+    if (opts->autoranks && (opts->autotune || halo == HALO_NEIGHBOR)) {
+        return "-a takes no -A or neighbor exchange";
+    }
+    if (opts->job_file != NULL &&
+        (problem != JACOBI_GRID || opts->counters || opts->baseline_file != NULL ||
+         opts->snapshot_prefix != NULL || opts->autotune || opts->autoranks ||
+         opts->trace_file != NULL || halo == HALO_NEIGHBOR || halo == HALO_RMA)) {
+        return "-F solves grids with no -c, -b, -S, -A, -a, -j, rma or neighbor exchange";
+    }
+    if (problem != JACOBI_SPARSE && opts->matrix_file != NULL) {
+        return "-M needs -m sparse";
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Solve every job of a job file over groups of processes.
+ *
+ * @param comm Communicator of every process
+ * @param opts Parsed options
+ * @param halo Ghost rows exchange backend
+ * @param compress Ghost rows compression mode
+ * @return int 1 if a solution differs from serial one, 0 otherwise
+ */
+static int solve_farm(MPI_Comm comm, struct options *opts, int halo, int compress) {
+    int nproc;
+    int me;
+    struct farm farm;
+    struct farm_job *jobs = NULL;
+    int job_count = -1;
+    int group_size;
+    int failed;
+
+    MPI_Comm_size(comm, &nproc);
+    MPI_Comm_rank(comm, &me);
+    group_size = (opts->group_size < nproc)? opts->group_size: nproc;
+
+    // MASTER reads jobs and hands them to everyone
+    if (me == MASTER) {
+        job_count = farm_read(opts->job_file, &jobs);
+        if (job_count < 0) {
+            fprintf(stderr, "\a[P%d] Cannot read jobs from %s!\n", me, opts->job_file);
+        }
+    }
+    MPI_Bcast(&job_count, 1, MPI_INT, MASTER, comm);
+    if (job_count < 0) {
+        MPI_Abort(comm, EXIT_FAILURE);
+    }
+    if (me != MASTER) {
+        jobs = malloc(job_count * sizeof *jobs);
+    }
+    MPI_Bcast(jobs, job_count * sizeof *jobs, MPI_BYTE, MASTER, comm);
+
+    // check whether every processor receives at least 2 rows
+    for (int j = 0; j < job_count; j++) {
+        if (jobs[j].n / group_size < 2) {
+            if (me == MASTER) {
+                fprintf(
+                    stderr,
+                    "\a[P%d] Job %d: every processor of a group must receive "
+                    "at least 2 rows (%d/%d is %d)!\n",
+                    me,
+                    j,
+                    jobs[j].n,
+                    group_size,
+                    jobs[j].n / group_size
+                );
+            }
+
+            MPI_Abort(comm, EXIT_FAILURE);
+        }
+    }
+
+    if (me == MASTER) {
+        printf(
+            "Task farm: %d jobs from %s, groups of %d processes, %s exchange\n",
+            job_count,
+            opts->job_file,
+            group_size,
+            HALO_NAMES[halo]
+        );
+        printf("\n");
+        fflush(stdout);
+    }
+    farm_create(&farm, comm, group_size, jobs, job_count);
+    farm_run(&farm, halo, compress, opts->verify);
+    if (farm_report(&farm, opts->output_file) != 0) {
+        fprintf(stderr, "\a[P%d] Cannot write results in %s\n", me, opts->output_file);
+    } else if (me == MASTER) {
+        printf("Writing result in %s\n", opts->output_file);
+        fflush(stdout);
+    }
+    failed = farm.failed;
+    farm_free(&farm);
+    free(jobs);
+
+    return failed;
+}
+
 /**
  * @brief The main function of Jacobi method in parallel version.
- * 
+ *
  * @param argc Count of command-line parameters
  * @param argv Command-line parameters
  * @return int Return value indicating whether program execution succeded
@@ -53,22 +333,38 @@ int main (int argc, char **argv) {
     // MPI management variables
     int nproc;
     int me;
-    const MPI_Comm COMM = MPI_COMM_WORLD;
-    MPI_Status status;
-    int *sendcounts, *recvcounts;
-    int *senddispls, *recvdispls;
-    extern int MASTER; // TODO try nproc - 1;
-    extern int TAG;
+    MPI_Comm COMM = MPI_COMM_WORLD;
+    MPI_Comm SOLVE;
+    int active;
+    MPI_Comm identity = MPI_COMM_NULL;
+    MPI_Comm placed = MPI_COMM_NULL;
+    struct placement_links launched_links;
+    struct placement_links placed_links;
+    int world_me;
+    extern const int MASTER; // TODO try nproc - 1;
 
     // time management variables
     double t_start;
     double t_end;
     double t_max;
+    double *samples;
+    struct time_stats time_stats;
+    struct phases phases;
+    struct phase_stats *phase_stats;
+    struct trace trace;
 
     // program execution management
     unsigned char debug = 0;
     char *output_file;
     FILE *results;
+    struct options opts;
+    struct kernel_counters total_counters;
+    double bandwidth;
+    double ceiling;
+    struct regression regression;
+    double baseline;
+    char label[32];
+    int failed = 0;
 
     // business variables
     /**
@@ -76,22 +372,67 @@ int main (int argc, char **argv) {
      *
      */
     int n;
-    int local_rows;
-    int local_g_rows;
-    int first_g_row;
-    int last_g_row;
-    int last_local_row;
     /**
      * @brief The coefficient matrix in linear system
      *
      */
     double *A;
-    double *local_A;
-    double *local_A_g;
-    double *local_A_g_prime;
+    /**
+     * @brief The generated matrix, restored before every solution
+     *
+     */
+    double *A_0;
+    /**
+     * @brief The known terms of a dense system
+     *
+     */
+    double *b;
+    /**
+     * @brief The coefficient matrix of a sparse system
+     *
+     */
+    struct csr matrix;
+    /**
+     * @brief The solution of a sparse system
+     *
+     */
+    double *x;
+    /**
+     * @brief The serial solution, to verify parallel one against
+     *
+     */
+    double *reference;
+    int reference_iterations;
+    double reference_err;
+    double max_difference;
+    int verified;
+    double tolerance;
+    struct slab slab;
+    struct dense dense;
+    struct sparse sparse;
+    int ghost_figures[4];
+    int problem;
+    const char *invalid;
     int num_iterations;
     double diffnorm;
-    double local_diffnorm;
+    double flops;
+    int halo;
+    int compress;
+    int backend;
+    int mode;
+    int topology;
+    int tuning;
+    const char *tune_file;
+    struct tuning *tuned;
+    char host[MPI_MAX_PROCESSOR_NAME];
+    int host_length;
+    int on_node;
+    double halo_bytes[2];
+    double memory[3];
+    struct perfmodel model;
+    double predicted[2];
+    struct snapshot snapshot;
+    double snapshot_figures[3];
 
     // initialize MPI environment
     MPI_Init(&argc, &argv);
@@ -103,469 +444,727 @@ int main (int argc, char **argv) {
         printf("Running %s over %d processes...\n\n\v", argv[0], nproc);
         fflush(stdout);
     }
-    if (debug && me != MASTER) {
-        printf("Running %s over %d processes...\n\n\v", argv[0], nproc);
-        fflush(stdout);
-    }
 
     // check for command-line arguments
-    if (argc < 3) {
+    if (parse_options(argc, argv, "cr:w:Vb:e:x:z:S:k:s:AT:m:M:Pj:aF:g:", &opts) != 0 ||
+        (halo = halo_parse(opts.halo)) < 0 ||
+        (compress = compress_parse(opts.compress)) < 0 ||
+        (problem = jacobi_mode_parse(opts.mode)) < 0) {
         if (me == MASTER) {
             printf("\aInsufficient number of parameters!\n");
-            printf("Usage: %s <matrixOrder> <outputFileName> [<debugFlag>]\n\n", argv[0]);
+            printf(
+                "Usage: %s [-c] [-r <repetitions>] [-w <warmup>] [-V] "
+                "[-b <baselineFile> [-e <band>]] [-x <exchange>] [-z <compression>] "
+                "[-S <snapshotPrefix> [-k <every>] [-s <stride>]] [-A] [-T <tuneFile>] [-m <mode> [-M <matrixFile>]] [-P] [-j <traceFile>] [-a] [-F <jobFile> [-g <groupSize>]] "
+                "<matrixOrder>[,<matrixOrder>...] <outputFileName> [<debugFlag>]\n",
+                argv[0]
+            );
+            printf("\t-c: count hardware events and print roofline report\n");
+            printf("\t-r: timed solutions for every matrix order (default 1)\n");
+            printf("\t-w: untimed warmup solutions for every matrix order (default 0)\n");
+            printf("\t-V: fail if solution differs from serial one\n");
+            printf("\t-b: fail if significantly slower than baseline results\n");
+            printf("\t-e: relative noise band over baseline time (default %.2f)\n", NOISE_BAND);
+            printf("\t-x: ghost rows exchange, sendrecv, shm, rma or neighbor (default sendrecv)\n");
+            printf("\t-z: ghost rows compression, none, lossless or lossy (default none),\n");
+            printf("\t    with sendrecv or shm exchange only\n");
+            printf("\t-S: write residual history and field snapshots in background\n");
+            printf("\t-k: iterations between field snapshots (default %d)\n", SNAPSHOT_EVERY);
+            printf("\t-s: rows and columns between sampled elements (default 1)\n");
+            printf("\t-A: tune exchange and compression, unless given, and cache them\n");
+            printf("\t-T: tuning cache file (default %s)\n", TUNE_FILE);
+            printf("\t-m: problem, grid, dense diagonally dominant Ax=b or sparse Ax=b\n");
+            printf("\t    (default grid), dense and sparse ones with no -c, -x, -z, -S or -A,\n");
+            printf("\t    active on jacobi-serial only\n");
+            printf("\t-M: read sparse matrix from MatrixMarket file, matrix orders are ignored\n");
+            printf("\t-P: rank processes by node and socket, so that neighbours share them\n");
+            printf("\t-j: write timeline of every rank as Chrome trace, latest %d phases each\n", TRACE_EVENTS);
+            printf("\t-a: solve grids over as many processes as predicted fastest, others idle,\n");
+            printf("\t    with no -A or neighbor exchange\n");
+            printf("\t-F: solve grids of job file, a matrix order and optional seed per line,\n");
+            printf("\t    over groups taking jobs as they get free, matrix orders are ignored,\n");
+            printf("\t    with no -c, -b, -S, -A, -a, -j, rma or neighbor exchange\n");
+            printf("\t-g: processes of every task farm group (default 1)\n\n");
             fflush(stdout);
         }
 
         MPI_Abort(COMM, EXIT_FAILURE);
         exit(EXIT_FAILURE);
     }
-    else if (argc == 3) {
-        n = atoi(argv[1]);
-        output_file = malloc ((strlen(argv[2]) + 1) * sizeof output_file);
-        sprintf(output_file, "%s", argv[2]);
-        debug = 0;
-    }
-    else {
-        n = atoi(argv[1]);
-        output_file = malloc ((strlen(argv[2]) + 1) * sizeof output_file);
-        sprintf(output_file, "%s", argv[2]);
-        debug = (unsigned char) atoi(argv[3]);
-    }
-
-    if (me == MASTER) {
-        printf("Matrix dimension: %dx%d (%d elements)\n", n, n, n*n);
-        printf("\n");
-        fflush(stdout);
-    }
-
-    // check whether number of processor is power of 2
-    // if ((nproc & (nproc - 1)) != 0) {
-    //     if (me == MASTER) {
-    //         fprintf(
-    //             stderr,
-    //             "\a[P%d] Number of processor must be a power of 2!\n",
-    //             me
-    //         );
-    //     }
-
-    //     MPI_Abort(COMM, EXIT_FAILURE);
-    // }
-    // else if (n == nproc) {
-    if (n == nproc) {
+    if ((invalid = check_options(&opts, halo, compress, problem)) != NULL) {
         if (me == MASTER) {
-            fprintf(
-                stderr,
-                "\a[P%d] Matrix size must be such that every processor receives ",
-                me
-            );
-            fprintf(
-                stderr,
-                "at least 2 rows (%d/%d is 1)!",
-                n,
-                nproc
-            );
+            printf("\aInvalid options: %s!\n", invalid);
+            fflush(stdout);
         }
 
         MPI_Abort(COMM, EXIT_FAILURE);
+        exit(EXIT_FAILURE);
     }
+    output_file = opts.output_file;
+    debug = opts.debug;
 
-    if (debug) {
-        printf("\n\t\t>>> PROCESS %d OF %d <<<\n\n", me, nproc);
-        fflush(stdout);
+    // rank processes anew by node and socket, so that slab
+    // neighbours share them whenever they can
+    if (opts.placement) {
+        placement_links(COMM, &launched_links);
+        placement_reorder(COMM, &placed);
+        COMM = placed;
+        MPI_Comm_rank(COMM, &me);
+        placement_links(COMM, &placed_links);
+        report_placement(COMM, &launched_links, &placed_links);
     }
 
-    // generate matrix vector
-    A = malloc(n * n * sizeof *A);
-    if (me == MASTER) {
-        if (debug) {
-            printf("[P%d] Generating matrix...\n", me);
-            printf("\n");
-            fflush(stdout);
+    // a task farm solves jobs of its own, one solution each
+    if (opts.job_file != NULL) {
+        failed = solve_farm(COMM, &opts, halo, compress);
+        free_options(&opts);
+        if (placed != MPI_COMM_NULL) {
+            MPI_Comm_free(&placed);
+        }
+        if (me == MASTER && failed) {
+            fprintf(stderr, "\a%s failed verification!\n", argv[0]);
+        }
+        if (me == MASTER && !failed) {
+            printf("\n\v%s terminated succesfully!\n", argv[0]);
         }
 
-        generate_matrix_array(A, n, n, LOWER_BOUND, UPPER_BOUND, SEED);
+        MPI_Finalize();
 
-        if (debug) {
-            printf("[P%d] Generated matrix:\n", me);
-            print_matrix_array(A, n, n);
-            printf("\n");
-            fflush(stdout);
+        return failed? EXIT_FAILURE: EXIT_SUCCESS;
+    }
+
+    // configurations tuned by an earlier run on this host apply
+    // unless given on command line, -A tunes them anew
+    tune_file = (opts.tune_file != NULL)? opts.tune_file: TUNE_FILE;
+    // cached configurations are per number of processes, which
+    // is not known beforehand when picked by cost model
+    tuning = opts.halo == NULL && opts.compress == NULL && problem == JACOBI_GRID &&
+        !opts.autoranks;
+    tuned = malloc(opts.size_count * sizeof *tuned);
+    MPI_Get_processor_name(host, &host_length);
+    MPI_Bcast(host, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, MASTER, COMM);
+    for (int s = 0; s < opts.size_count; s++) {
+        tuned[s].backend = -1;
+        if (tuning && !opts.autotune && me == MASTER) {
+            tune_lookup(tune_file, host, opts.sizes[s], nproc, &tuned[s]);
         }
     }
+    MPI_Bcast(tuned, opts.size_count * sizeof *tuned, MPI_BYTE, MASTER, COMM);
 
-    // calculate the number of rows to distribute
-    // calculate number of elements and 
-    // matrix offsets for every processor
-    if (debug && me == MASTER) {
-        printf(
-            "[P%d] %d mod (%d - 1) is %d\n",
-            me,
-            n,
-            nproc,
-            (n % (nproc - 1))
-        );
-        printf("\n");
-        fflush(stdout);
+    // neighbour exchange needs a topology, whenever it may be picked
+    topology = halo == HALO_NEIGHBOR || (tuning && opts.autotune);
+    for (int s = 0; s < opts.size_count; s++) {
+        topology |= tuned[s].backend == HALO_NEIGHBOR;
     }
 
-    sendcounts = malloc(nproc * sizeof *sendcounts);
-    recvcounts = malloc(nproc * sizeof *recvcounts);
-    senddispls = malloc(nproc * sizeof *senddispls);
-    recvdispls = malloc(nproc * sizeof *recvdispls);
-    scatterv_gatherv_describers(
-        sendcounts,
-        senddispls,
-        recvcounts,
-        recvdispls,
-        &local_rows,
-        nproc,
-        me,
-        n
-    );
+    // let MPI library rank processes anew along the chain,
+    // every process solves the slab of its topology rank
+    if (topology) {
+        world_me = me;
+        halo_topology(COMM, 0, &identity);
+        halo_topology(COMM, 1, &COMM);
+        MPI_Comm_rank(COMM, &me);
+        report_remap(world_me, COMM);
+    }
 
-    // add 1 row to last processor, 2 rows for other ones
-    local_g_rows = (me != nproc - 1)?
-        local_rows + 2:
-        local_rows + 1;
-    // print number of rows, cells and offsets
-    if (debug) {
-        if (me == MASTER) {
-            for (int p = 0; p < nproc; p++)
-            {
-                printf("\n");
-                printf(
-                    "I'll send to P%d %d cells from cell %d\n",
-                    p,
-                    sendcounts[p],
-                    senddispls[p]
+    // a matrix read from file has an order of its own, it is read
+    // by MASTER as ranked for solution, once processes are placed
+    if (opts.matrix_file != NULL) {
+        n = -1;
+        if (me == MASTER && csr_read(&matrix, opts.matrix_file) == 0) {
+            n = matrix.rows;
+        }
+        MPI_Bcast(&n, 1, MPI_INT, MASTER, COMM);
+        if (n < 0) {
+            MPI_Abort(COMM, EXIT_FAILURE);
+        }
+        opts.sizes[0] = n;
+        opts.size_count = 1;
+    }
+
+    // check whether every processor receives at least 2 rows,
+    // processes picked by cost model always do
+    for (int s = 0; s < opts.size_count; s++) {
+        if (!opts.autoranks && opts.sizes[s] / nproc < 2) {
+            if (me == MASTER) {
+                fprintf(
+                    stderr,
+                    "\a[P%d] Matrix size must be such that every processor receives ",
+                    me
                 );
-                printf(
-                    "I'll get back from P%d %d cells from cell %d\n",
-                    p,
-                    recvcounts[p],
-                    recvdispls[p]
+                fprintf(
+                    stderr,
+                    "at least 2 rows (%d/%d is %d)!",
+                    opts.sizes[s],
+                    nproc,
+                    opts.sizes[s] / nproc
                 );
-                printf("\n");
             }
-        }
-
-        printf(
-            "[P%d] Local ghosted matrix will have %d rows\n",
-            me,
-            local_g_rows
-        );
-        printf("\n");
-        fflush(stdout);
-        // MPI_Pause(me, MASTER, COMM);
-    }
 
-    if (debug) {
-        printf(
-            "[P%d] I will take %d rows\n",
-            me,
-            local_g_rows
-        );
-        printf("\n");
-        printf(
-            "[P%d] Convergence threshold is %.3e\n",
-            me,
-            CONVERGENCE_THRESHOLD
-        );
-        printf("\n");
-        fflush(stdout);
+            MPI_Abort(COMM, EXIT_FAILURE);
+        }
     }
 
-    // calculate inner rows indexes
-    // for row exchange among processors
-    first_g_row = n;
-    last_g_row = (sendcounts[me]/n - 2) * n;
-    last_local_row = last_g_row + n;
     if (debug) {
-        printf("[P%d] First significative row index: %d\n", me, first_g_row);
-        printf("[P%d] Last significative row index: %d\n", me, last_g_row);
-        printf("[P%d] Last ghosted row index: %d\n", me, last_local_row);
-        printf("\n");
+        printf("\n\t\t>>> PROCESS %d OF %d <<<\n\n", me, nproc);
         fflush(stdout);
-        // MPI_Pause(me, MASTER, COMM);
     }
 
-    local_A_g = malloc(sendcounts[me] * sizeof *local_A_g);
-    local_A_g_prime = malloc(sendcounts[me] * sizeof *local_A_g_prime);
-    memset(local_A_g_prime, 0, sendcounts[me]);
-
-    // distribute initial matrix slices to processes
-    MPI_Scatterv(
-        A, sendcounts, senddispls, MPI_DOUBLE,
-        local_A_g, sendcounts[me], MPI_DOUBLE,
-        MASTER, COMM
-    );
-    // no more need for counts and displacements arrays
-    free(sendcounts);
-    free(senddispls);
-
-    // last row in last submatrix of last process
-    // is not considered for row replacements
-    // between local_A_g and local_A_g_prime
-    if (me == nproc - 1) {
-        for (int i = last_local_row; i < last_local_row + n; i++) {
-            local_A_g_prime[i] = local_A_g[i];
-        }
+    // measure aggregate bandwidth ceiling with every process
+    // streaming at once
+    if (opts.counters) {
+        MPI_Barrier(COMM);
+        bandwidth = stream_triad_bandwidth(1);
+        MPI_Reduce(&bandwidth, &ceiling, 1, MPI_DOUBLE, MPI_SUM, MASTER, COMM);
     }
 
-    // apply Jacobi method over submatrices
-    num_iterations = 0;
-    t_start = MPI_Wtime();
-    do {
-        if (debug) {
-            printf("[P%d] Local ghosted matrix:\n", me);
-            print_matrix_array(local_A_g, local_g_rows, n);
+    // measure cost model figures with every process, before
+    // picking how many of them solve every matrix order
+    if (opts.autoranks) {
+        perfmodel_calibrate(&model, COMM, 2, (int []) {1, PERFMODEL_MESSAGE}, NULL);
+        if (me == MASTER) {
+            printf(
+                "Cost model: %.3f ns per cell alone, %.3f ns with %d processes sweeping, "
+                "%.3f us latency, %.3f GB/s, %.3f us per reduction stage\n",
+                model.cell * 1E9,
+                model.cell_busy * 1E9,
+                nproc,
+                model.latency * 1E6,
+                (model.byte > 0.0)? 1E-9 / model.byte: 0.0,
+                model.stage * 1E6
+            );
             printf("\n");
             fflush(stdout);
         }
+    }
 
-        // apply a single iteration
-        jacobi_iteration(local_A_g, local_A_g_prime, local_g_rows, n);
-        num_iterations++;
+    samples = malloc(opts.repetitions * sizeof *samples);
+    phase_stats = malloc(opts.size_count * sizeof *phase_stats);
+    if (opts.trace_file != NULL) {
+        trace_create(&trace, TRACE_EVENTS);
+    }
+    for (int s = 0; s < opts.size_count; s++) {
+        n = opts.sizes[s];
+        phases_reset(&phases);
+        phases.trace = (opts.trace_file != NULL)? &trace: NULL;
 
-        if (debug) {
-            printf("[P%d] Local prime matrix:\n", me);
-            print_matrix_array(local_A_g_prime, local_g_rows, n);
+        if (me == MASTER) {
+            printf(
+                "Matrix dimension: %dx%d (%zu elements), %d+%d solutions\n",
+                n,
+                n,
+                (size_t) n * n,
+                opts.warmup,
+                opts.repetitions
+            );
             printf("\n");
             fflush(stdout);
         }
 
-        // check for convergence test before reiterating
-        local_diffnorm = convergence_check_g(
-            local_A_g,
-            local_A_g_prime,
-            local_g_rows,
-            n
-        );
-        if (debug) {
-            printf(
-                "[P%d] At iteration %d, my local convergence value is %.3e\n",
-                me,
-                num_iterations,
-                local_diffnorm
-            );
-            fflush(stdout);
+        // solve over processes predicted fastest, leaving
+        // the others idle until next matrix order
+        SOLVE = COMM;
+        active = nproc;
+        if (opts.autoranks) {
+            active = perfmodel_ranks(&model, n, nproc, MAX_ITERATIONS);
+            predicted[0] = perfmodel_solution(&model, n, active, MAX_ITERATIONS);
+            predicted[1] = perfmodel_solution(&model, n, nproc, MAX_ITERATIONS);
+            MPI_Comm_split(COMM, (me < active)? 0: MPI_UNDEFINED, me, &SOLVE);
+            if (me == MASTER) {
+                printf(
+                    "Active processes: %d of %d, %.3f ms predicted against %.3f ms over all of them "
+                    "(%d iterations)\n",
+                    active,
+                    nproc,
+                    predicted[0] * MS_IN_S,
+                    predicted[1] * MS_IN_S,
+                    MAX_ITERATIONS
+                );
+                printf("\n");
+                fflush(stdout);
+            }
+            if (SOLVE == MPI_COMM_NULL) {
+                continue;
+            }
         }
 
-        // evaluate convergence value from all processes
-        MPI_Allreduce(
-            &local_diffnorm, &diffnorm, 1,
-            MPI_DOUBLE, MPI_SUM, COMM
-        );
-        diffnorm = sqrt(diffnorm);
-        if (debug && me == MASTER) {
-            printf(
-                "[P%d] At iteration %d, global convergence value is %.3e\n",
-                me,
-                num_iterations,
-                diffnorm
-            );
-            printf("\n");
-            fflush(stdout);
+        // generate matrix vector once for every matrix order
+        A = NULL;
+        A_0 = NULL;
+        b = NULL;
+        x = NULL;
+        if (me == MASTER && problem == JACOBI_SPARSE) {
+            b = malloc(n * sizeof *b);
+            x = malloc(n * sizeof *x);
+            if (opts.matrix_file == NULL) {
+                csr_generate(&matrix, n, LOWER_BOUND, UPPER_BOUND, SEED);
+            }
+            csr_system(&matrix, b, LOWER_BOUND, UPPER_BOUND, SEED + 1);
+        } else if (me == MASTER && problem == JACOBI_DENSE) {
+            // matrix is left untouched by solution, no need to restore it
+            A_0 = malloc((size_t) n * n * sizeof *A_0);
+            b = malloc(n * sizeof *b);
+            generate_dd_system(A_0, b, n, LOWER_BOUND, UPPER_BOUND, SEED);
+        } else if (me == MASTER) {
+            if (debug) {
+                printf("[P%d] Generating matrix...\n", me);
+                printf("\n");
+                fflush(stdout);
+            }
+
+            A = malloc((size_t) n * n * sizeof *A);
+            A_0 = malloc((size_t) n * n * sizeof *A_0);
+            generate_matrix_array(A_0, n, n, LOWER_BOUND, UPPER_BOUND, SEED);
+
+            // slabs are scattered from A_0 and gathered into A,
+            // whose border rows are never gathered, so set them once
+            memcpy(A, A_0, n * sizeof *A);
+            memcpy(&A[(size_t) (n - 1) * n], &A_0[(size_t) (n - 1) * n], n * sizeof *A);
+
+            if (debug) {
+                printf("[P%d] Generated matrix:\n", me);
+                print_matrix_array(A_0, n, n);
+                printf("\n");
+                fflush(stdout);
+            }
         }
 
-        if (debug) {
-            printf("[P%d] Start row exchange...\n", me);
-            fflush(stdout);
+        // search fastest configuration over short solutions
+        backend = halo;
+        mode = compress;
+        if (tuning && opts.autotune) {
+            tune_search(SOLVE, n, A_0, &tuned[s]);
+            if (me == MASTER && tune_record(tune_file, host, n, active, &tuned[s]) != 0) {
+                fprintf(stderr, "\a[P%d] Cannot write tuning cache %s\n", me, tune_file);
+            }
+        }
+        if (tuning && tuned[s].backend >= 0) {
+            backend = tuned[s].backend;
+            mode = tuned[s].compress;
+            if (me == MASTER) {
+                printf(
+                    "Tuned configuration for %s, n=%d, np=%d: %s exchange, %s compression%s\n",
+                    host,
+                    n,
+                    active,
+                    HALO_NAMES[backend],
+                    COMPRESS_NAMES[mode],
+                    opts.autotune? "": " (cached)"
+                );
+                printf("\n");
+                fflush(stdout);
+            }
         }
 
-        // make sure everyone performed an iteration
-        // before exchanging rows
-        MPI_Barrier(COMM);
+        if (problem == JACOBI_DENSE) {
+            dense_create(&dense, SOLVE, n, &phases);
+            phases_lap(&phases, PHASE_STARTUP);
+        } else if (problem == JACOBI_SPARSE) {
+            if (sparse_create(&sparse, SOLVE, &matrix, &phases) != 0) {
+                if (me == MASTER) {
+                    fprintf(stderr, "\a[P%d] Sparse matrix has a missing or zero diagonal element!\n", me);
+                }
+                MPI_Abort(SOLVE, EXIT_FAILURE);
+            }
+            phases_lap(&phases, PHASE_STARTUP);
 
-        // send upper unghosted row
-        // to previous process and
-        // receive first row
-        // from previous one
-        // P0 has no previous one
-        if (me != MASTER) {
-            if (debug) {
+            // ghost entries in all and worst process
+            ghost_figures[0] = ghost_figures[1] = sparse.ghosts;
+            ghost_figures[2] = sparse.recv_neighbours;
+            ghost_figures[3] = sparse.interior_count;
+            MPI_Reduce(
+                me == MASTER? MPI_IN_PLACE: &ghost_figures[0], &ghost_figures[0], 1,
+                MPI_INT, MPI_SUM, MASTER, SOLVE
+            );
+            MPI_Reduce(
+                me == MASTER? MPI_IN_PLACE: &ghost_figures[1], &ghost_figures[1], 2,
+                MPI_INT, MPI_MAX, MASTER, SOLVE
+            );
+            MPI_Reduce(
+                me == MASTER? MPI_IN_PLACE: &ghost_figures[3], &ghost_figures[3], 1,
+                MPI_INT, MPI_SUM, MASTER, SOLVE
+            );
+            if (me == MASTER) {
                 printf(
-                    "[P%d] Exchanging with process %d\n",
-                    me,
-                    me - 1
+                    "Sparse matrix: %zu nonzeros, %d ghost entries (%d at most per process, "
+                    "from %d processes at most), %.1f%% of rows updated during exchange\n",
+                    matrix.nnz,
+                    ghost_figures[0],
+                    ghost_figures[1],
+                    ghost_figures[2],
+                    100.0 * ghost_figures[3] / n
                 );
+                printf("\n");
                 fflush(stdout);
             }
+        } else {
+            slab_create(&slab, SOLVE, n, debug, &phases, backend);
+            if (mode != COMPRESS_NONE) {
+                halo_compress(&slab.halo, mode);
+            }
+            if (opts.snapshot_prefix != NULL) {
+                snapshot_create(
+                    &snapshot, opts.snapshot_prefix, n, me,
+                    opts.snapshot_every, opts.snapshot_stride,
+                    (int) (slab.recvdispls[me] / n), slab.local_rows
+                );
+                slab.snapshot = &snapshot;
+            }
+            phases_lap(&phases, PHASE_STARTUP);
 
-            MPI_Sendrecv(
-                // send first unghosted line to previous process
-                &local_A_g_prime[first_g_row], n, MPI_DOUBLE, me - 1, TAG,
-                // receive first line from previous process
-                // and put it as my first ghosted line
-                local_A_g_prime, n, MPI_DOUBLE, me - 1, TAG,
-                COMM, &status
+            // every neighbour link is counted by both ends
+            on_node = halo_on_node(&slab.halo);
+            MPI_Reduce(
+                me == MASTER? MPI_IN_PLACE: &on_node, &on_node, 1, MPI_INT, MPI_SUM,
+                MASTER, SOLVE
             );
+            if (me == MASTER) {
+                printf(
+                    "Ghost rows exchange: %s, %d of %d neighbour links through shared memory\n",
+                    HALO_NAMES[backend],
+                    on_node / 2,
+                    active - 1
+                );
+                printf("\n");
+                fflush(stdout);
+            }
+
+            // compare exchange between topology and original ranking
+            if (backend == HALO_NEIGHBOR) {
+                t_end = halo_probe(identity, n, PROBE_ROUNDS);
+                t_max = halo_probe(SOLVE, n, PROBE_ROUNDS);
+                if (me == MASTER) {
+                    printf(
+                        "Exchange time: %.3f us as ranked, %.3f us as reordered (%+.1f%%)\n",
+                        t_end * 1E6,
+                        t_max * 1E6,
+                        (t_max / t_end - 1.0) * 100
+                    );
+                    printf("\n");
+                    fflush(stdout);
+                }
+            }
         }
 
-        // send lower unghosted row
-        // to next process and
-        // receive last row
-        // from next one
-        // Pnproc-1 has no next one
-        if (me != nproc - 1) {
+        for (int r = 0; r < opts.warmup + opts.repetitions; r++) {
+            // leave warmup solutions out of phases and counters
+            if (r == opts.warmup) {
+                phases_discard(&phases);
+                if (opts.counters) {
+                    counters_open();
+                }
+            }
+
+            // distribute initial matrix slices to processes
+            if (problem == JACOBI_DENSE) {
+                dense_scatter(&dense, A_0, b);
+            } else if (problem == JACOBI_SPARSE) {
+                sparse_scatter(&sparse, b);
+            } else {
+                slab_scatter(&slab, A_0);
+            }
+
+            // apply Jacobi method over submatrices
+            // and recollect them, starting all together;
+            // dense solution is already on every process
+            MPI_Barrier(SOLVE);
+            t_start = MPI_Wtime();
+            if (problem == JACOBI_DENSE) {
+                dense_iterate(&dense);
+            } else if (problem == JACOBI_SPARSE) {
+                sparse_iterate(&sparse);
+                sparse_gather(&sparse, x);
+            } else {
+                slab_iterate(&slab);
+                slab_gather(&slab, A);
+            }
+            t_end = MPI_Wtime() - t_start;
+
+            // calculate elapsed time
+            MPI_Reduce(
+                &t_end, &t_max, 1, MPI_DOUBLE, MPI_MAX,
+                MASTER, SOLVE
+            );
             if (debug) {
-                printf(
-                    "[P%d] Exchanging with process %d\n",
-                    me,
-                    me + 1
-                );
+                printf("[P%d] Local calculation time: %.3lf ms\n", me, t_end * MS_IN_S);
                 fflush(stdout);
             }
+            if (r >= opts.warmup) {
+                samples[r - opts.warmup] = t_max;
+            }
 
-            MPI_Sendrecv(
-                // send last unghosted line to next process
-                &local_A_g_prime[last_g_row], n, MPI_DOUBLE, me + 1, TAG,
-                // receive last line from next process
-                // and put it as my last ghosted line
-                &local_A_g_prime[last_local_row], n, MPI_DOUBLE, me + 1, TAG,
-                COMM, &status
+            // residual history is written out of timed region
+            if (opts.snapshot_prefix != NULL && me == MASTER) {
+                snapshot_flush(&snapshot);
+            }
+        }
+
+        // reduce per-phase times of every rank
+        phases_reduce(&phases, &phase_stats[s], n, opts.repetitions, SOLVE);
+        if (opts.snapshot_prefix != NULL) {
+            // wait for last snapshots, writer time is per process
+            snapshot_free(&snapshot);
+            snapshot_figures[0] = snapshot.taken;
+            snapshot_figures[1] = snapshot.dropped;
+            snapshot_figures[2] = snapshot.write_seconds;
+            MPI_Reduce(
+                me == MASTER? MPI_IN_PLACE: snapshot_figures, snapshot_figures,
+                3, MPI_DOUBLE, MPI_MAX, MASTER, SOLVE
             );
+            if (snapshot.failed) {
+                fprintf(stderr, "\a[P%d] Cannot write snapshots %s-%d-*\n", me, opts.snapshot_prefix, n);
+            }
+        }
+        if (problem == JACOBI_DENSE) {
+            num_iterations = dense.num_iterations;
+            diffnorm = dense.diffnorm;
+            halo_bytes[0] = halo_bytes[1] = 0.0;
+        } else if (problem == JACOBI_SPARSE) {
+            num_iterations = sparse.num_iterations;
+            diffnorm = sparse.diffnorm;
+            halo_bytes[0] = halo_bytes[1] = 0.0;
+        } else {
+            num_iterations = slab.num_iterations;
+            diffnorm = slab.diffnorm;
+            halo_bytes[0] = slab.halo.raw_bytes;
+            halo_bytes[1] = slab.halo.packed_bytes;
+        }
+        MPI_Reduce(
+            me == MASTER? MPI_IN_PLACE: halo_bytes, halo_bytes, 2, MPI_DOUBLE, MPI_SUM,
+            MASTER, SOLVE
+        );
+        // peak memory so far, MASTER holding whole matrices apart
+        memory[0] = memory[1] = memory[2] = peak_memory();
+        MPI_Reduce(
+            me == MASTER? MPI_IN_PLACE: &memory[0], &memory[0], 1, MPI_DOUBLE, MPI_MAX,
+            MASTER, SOLVE
+        );
+        MPI_Reduce(
+            me == MASTER? MPI_IN_PLACE: &memory[1], &memory[1], 1, MPI_DOUBLE, MPI_MIN,
+            MASTER, SOLVE
+        );
+        if (opts.counters) {
+            counters_close();
+            reduce_counters(counters_get(), &total_counters, SOLVE);
         }
 
-        if (debug) {
-            printf("[P%d] Local prime matrix:\n", me);
-            print_matrix_array(local_A_g_prime, local_g_rows, n);
+        if (me == MASTER) {
+            summarize_times(samples, opts.repetitions, &time_stats);
+            printf(
+                "[P%d] The solution took %d iterations and has an error of %.3e.\n",
+                me,
+                num_iterations,
+                diffnorm
+            );
+            printf(
+                "[P%d] Max time: %.3f ms median, %.3f ms min, %.3f ms max\n",
+                me,
+                time_stats.median * MS_IN_S,
+                time_stats.min * MS_IN_S,
+                time_stats.max * MS_IN_S
+            );
+            if (opts.autoranks) {
+                predicted[0] = perfmodel_solution(&model, n, active, num_iterations);
+                printf(
+                    "[P%d] Predicted time over %d processes: %.3f ms for %d iterations, "
+                    "%.3f ms achieved (%+.1f%%)\n",
+                    me,
+                    active,
+                    predicted[0] * MS_IN_S,
+                    num_iterations,
+                    time_stats.median * MS_IN_S,
+                    (time_stats.median / predicted[0] - 1.0) * 100
+                );
+            }
+            if (mode != COMPRESS_NONE && halo_bytes[0] > 0.0) {
+                printf(
+                    "[P%d] Ghost rows compression: %s, %.1f MiB sent for %.1f MiB of rows (%.1f%%)\n",
+                    me,
+                    COMPRESS_NAMES[mode],
+                    halo_bytes[1] / (1 << 20),
+                    halo_bytes[0] / (1 << 20),
+                    halo_bytes[1] / halo_bytes[0] * 100
+                );
+            } else if (mode != COMPRESS_NONE) {
+                printf(
+                    "[P%d] Ghost rows compression: %s, no rows sent as messages\n",
+                    me,
+                    COMPRESS_NAMES[mode]
+                );
+            }
+            if (opts.snapshot_prefix != NULL) {
+                printf(
+                    "[P%d] Snapshots: %.0f fields written, %.0f dropped, "
+                    "%.3f ms of writing in background (see snapshot phase for overhead)\n",
+                    me,
+                    snapshot_figures[0],
+                    snapshot_figures[1],
+                    snapshot_figures[2] * MS_IN_S
+                );
+            }
+            printf(
+                "[P%d] Peak memory: %.1f MiB on MASTER, %.1f to %.1f MiB per rank\n",
+                me,
+                memory[2] / (1 << 20),
+                memory[1] / (1 << 20),
+                memory[0] / (1 << 20)
+            );
             printf("\n");
+            printf("Writing result in %s\n", output_file);
             fflush(stdout);
-            // pause for debug purposes
-            // MPI_Pause(me, MASTER, COMM);
-        }
-
-        // swap matrices
-        replace_partial(
-            local_A_g,
-            local_A_g_prime,
-            n,
-            first_g_row,
-            last_local_row,
-            me
-        );
+            results = fopen(output_file, "a");
+            fprintf(
+                results,
+                "%d,%f,%f,%f,%d\n",
+                active,
+                time_stats.median,
+                time_stats.min,
+                time_stats.max,
+                n
+            );
+            fflush(results);
+            // close file
+            fclose(results);
 
-        if (debug) {
-            printf("[P%d] After swap, local matrix is now:\n", me);
-            print_matrix_array(local_A_g, local_g_rows, n);
+            printf("\n");
+            phases_print(&phase_stats[s]);
+            if (opts.counters) {
+                printf("\n");
+                counters_report(&total_counters, ceiling);
+            }
             printf("\n");
             fflush(stdout);
-            // pause for debug purposes
-            // MPI_Pause(me, MASTER, COMM);
-        }
-    } while (
-        diffnorm > CONVERGENCE_THRESHOLD &&
-        num_iterations < MAX_ITERATIONS
-    );
 
-    // no more need for local prime matrix
-    free(local_A_g_prime);
+            // solve the same matrix serially and compare
+            // lossy compression is bounded by convergence threshold,
+            // and may stop one iteration apart
+            if (opts.verify) {
+                tolerance = (mode == COMPRESS_LOSSY)?
+                    CONVERGENCE_THRESHOLD: VERIFY_TOLERANCE;
+                if (problem == JACOBI_DENSE) {
+                    reference = malloc(n * sizeof *reference);
+                    reference_iterations = jacobi_dense(A_0, b, reference, n, &reference_err);
+                    verified = verify_solution(
+                        dense.x, reference, 1, n, tolerance, &max_difference
+                    );
+                } else if (problem == JACOBI_SPARSE) {
+                    reference = malloc(n * sizeof *reference);
+                    reference_iterations = jacobi_sparse(&matrix, b, reference, &reference_err);
+                    verified = verify_solution(
+                        x, reference, 1, n, tolerance, &max_difference
+                    );
+                } else {
+                    reference = malloc((size_t) n * n * sizeof *reference);
+                    copy_matrix_array(A_0, reference, n, n);
+                    reference_iterations = jacobi(reference, n, n, &reference_err);
+                    verified = verify_solution(
+                        A, reference, n, n, tolerance, &max_difference
+                    );
+                }
+                if (verified &&
+                    abs(reference_iterations - num_iterations) <=
+                        (mode == COMPRESS_LOSSY)) {
+                    printf(
+                        "n=%d: solution matches serial one (max difference %.3e)\n",
+                        n,
+                        max_difference
+                    );
+                } else {
+                    printf(
+                        "n=%d: MISMATCH, %d iterations against %d serial ones, "
+                        "max difference %.3e over %.3e\n",
+                        n,
+                        num_iterations,
+                        reference_iterations,
+                        max_difference,
+                        tolerance
+                    );
+                    failed = 1;
+                }
+                printf("\n");
+                fflush(stdout);
+                free(reference);
+            }
 
-    // unghost local submatrices before recollection
-    // unghosted submatrices have 2 rows less
-    local_A = malloc(local_rows * n * sizeof *local_A);
-    // memset(local_A, 0, local_rows * n);
-    if (debug) {
-        printf(
-            "[P%d] Unghosting %dx%d local matrix from %dx%d ghosted one...\n",
-            me,
-            local_rows,
-            n,
-            local_g_rows,
-            n
-        );
-        printf("[P%d] Local submatrix before unghosting:\n", me);
-        print_matrix_array(local_A_g, local_g_rows, n);
-        printf("\n");
-        fflush(stdout);
-        // MPI_Pause(me, MASTER, COMM);
-    }
-    for (int i = 0; i < local_rows; i++) {
-        for (int j = 0; j < n; j++) {
-            // offset is made of n
-            local_A[i*n + j] = local_A_g[i*n + n + j];
+            // check for performance regression
+            if (opts.baseline_file != NULL) {
+                sprintf(label, "n=%d np=%d", n, active);
+                if (baseline_median(opts.baseline_file, n, active, &baseline) != 0) {
+                    printf("%s: no baseline in %s, skipped\n\n", label, opts.baseline_file);
+                } else {
+                    check_regression(samples, opts.repetitions, baseline, opts.band, &regression);
+                    // a stencil update is 7 operations, a dense or sparse
+                    // row is 2 per element
+                    if (problem == JACOBI_DENSE) {
+                        flops = 2.0 * n * n * num_iterations;
+                    } else if (problem == JACOBI_SPARSE) {
+                        flops = 2.0 * matrix.nnz * num_iterations;
+                    } else {
+                        flops = 7.0 * (n - 2) * (n - 2) * num_iterations;
+                    }
+                    regression_print(label, &regression, flops);
+                    printf("\n");
+                    failed |= regression.regressed;
+                }
+                fflush(stdout);
+            }
         }
-    }
-    // no more need for local matrix
-    free(local_A_g);
-
-    if (debug) {
-        printf("[P%d] Local submatrix after unghosting:\n", me);
-        print_matrix_array(local_A, local_rows, n);
-        printf("\n");
-        fflush(stdout);
-        // MPI_Pause(me, MASTER, COMM);
-    }
 
-    // at last, recollect submatrices
-    MPI_Gatherv(
-        local_A, recvcounts[me], MPI_DOUBLE,
-        A, recvcounts, recvdispls, MPI_DOUBLE,
-        MASTER, COMM
-    );
-    // no more need for local unghosted matrix
-    // and count and displacement arrays
-    free(local_A);
-    free(recvcounts);
-    free(recvdispls);
-    if (debug && me == MASTER) {
-        printf(
-            "[P%d] After %d iteration, matrix is:\n",
-            me,
-            num_iterations
-        );
-        print_matrix_array(A, n, n);
-        printf("\n");
-        fflush(stdout);
-    }
-
-    t_end = MPI_Wtime() - t_start;
-    if (debug) {
-        printf("\n");
-        fflush(stdout);
+        // free memory
+        if (problem == JACOBI_DENSE) {
+            dense_free(&dense);
+        } else if (problem == JACOBI_SPARSE) {
+            sparse_free(&sparse);
+        } else {
+            slab_free(&slab);
+        }
+        if (me == MASTER) {
+            free(A);
+            free(A_0);
+            free(b);
+            free(x);
+            if (problem == JACOBI_SPARSE) {
+                csr_free(&matrix);
+            }
+        }
+        if (SOLVE != COMM) {
+            MPI_Comm_free(&SOLVE);
+        }
     }
 
-    // free memory
+    // write per-phase breakdown next to results file
     if (me == MASTER) {
-        free(A);
+        phases_write(output_file, phase_stats, opts.size_count);
     }
+    free(samples);
+    free(phase_stats);
+    free(tuned);
 
-    if (me == MASTER) {
-        printf(
-            "[P%d] The solution took %d iterations and has an error of %.3e.\n",
-            me,
-            num_iterations,
-            diffnorm
-        );
-        fflush(stdout);
+    // merge timelines of every rank, once nothing is timed anymore
+    if (opts.trace_file != NULL) {
+        if (trace_write(&trace, opts.trace_file, COMM) != 0) {
+            fprintf(stderr, "\a[P%d] Cannot write trace %s\n", me, opts.trace_file);
+        } else if (me == MASTER) {
+            printf("Trace written in %s\n", opts.trace_file);
+            fflush(stdout);
+        }
+        trace_free(&trace);
     }
 
-    // calculate elapsed time
-    MPI_Reduce(
-        &t_end, &t_max, 1, MPI_DOUBLE, MPI_MAX,
-        MASTER, COMM
-    );
-
-    if (debug) {
-        printf("[P%d] Local calculation time: %.3lf ms\n", me, t_end * MS_IN_S);
+    // everyone, get rid of file name
+    free_options(&opts);
+    if (topology) {
+        MPI_Comm_free(&identity);
+        MPI_Comm_free(&COMM);
     }
-    if (me == MASTER) {
-        printf("[P%d] Max time: %.3f ms\n", me, t_max * MS_IN_S);
-        printf("\n");
-        printf("Writing result in %s\n", output_file);
-        fflush(stdout);
-        results = fopen(output_file, "a");
-        fprintf(results, "%d,%f\n", nproc, t_max);
-        fflush(results);
-        // close file
-        fclose(results);
+    if (placed != MPI_COMM_NULL) {
+        MPI_Comm_free(&placed);
     }
 
-    // everyone, get rid of file name
-    free(output_file);
-
-    if (me == MASTER) {
+    if (me == MASTER && failed) {
+        fprintf(stderr, "\a%s failed verification or regression check!\n", argv[0]);
+    }
+    if (me == MASTER && !failed) {
         printf("\n\v%s terminated succesfully!\n", argv[0]);
     }
     if (debug && me != MASTER) {
@@ -574,5 +1173,5 @@ int main (int argc, char **argv) {
 
     MPI_Finalize();
 
-    return EXIT_SUCCESS;
+    return failed? EXIT_FAILURE: EXIT_SUCCESS;
 }
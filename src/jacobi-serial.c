@@ -22,8 +22,15 @@
 #include <string.h>
 #include <time.h>
 
+#include "active.h"
 #include "matrixutils.h"
+#include "csr.h"
 #include "jacobi.h"
+#include "options.h"
+#include "outofcore.h"
+#include "perfcounters.h"
+#include "regress.h"
+#include "stats.h"
 #include "misc.h"
 
 /**
@@ -64,13 +71,47 @@ int main(int argc, char** argv) {
      *
      */
     double *A;
-    int num_iterations;
-    double err;
+    /**
+     * @brief The generated matrix, restored before every solution
+     *
+     */
+    double *A_0;
+    /**
+     * @brief The known terms of a dense system
+     *
+     */
+    double *b = NULL;
+    /**
+     * @brief The solution of a dense system
+     *
+     */
+    double *x = NULL;
+    /**
+     * @brief The coefficient matrix of a sparse system
+     *
+     */
+    struct csr sparse;
+    double nnz = 0.0;
+    int mode;
+    double flops;
+    int num_iterations = 0;
+    double err = 0.0;
     double elapsedtime;
+    double *samples;
+    struct time_stats time_stats;
     struct timespec start, stop;
     unsigned char debug = 0;
     char *output_file;
     FILE *results;
+    struct options opts;
+    double ceiling = 0.0;
+    struct regression regression;
+    double baseline;
+    char label[32];
+    int failed = 0;
+    char *solution_file = NULL;
+    struct ooc_stats ooc_stats;
+    struct active_stats active_stats;
     // int p[2];
 
     printf("Running %s...\n\n\v", argv[0]);
@@ -83,80 +124,276 @@ int main(int argc, char** argv) {
     // }
 
     // reading dimension and debug flag from command line
-    if (argc < 3) {
+    if (parse_options(argc, argv, "cr:w:b:e:o:f:m:M:", &opts) != 0 ||
+        (mode = jacobi_mode_parse(opts.mode)) < 0) {
         printf("\aInsufficient number of parameters!\n");
-        printf("Usage: %s <matrixOrder> <outputFileName> [<debugFlag>]\n\n", argv[0]);
+        printf(
+            "Usage: %s [-c] [-r <repetitions>] [-w <warmup>] "
+            "[-b <baselineFile> [-e <band>]] [-o <gridFile> [-f <fused>]] [-m <mode> [-M <matrixFile>]] "
+            "<matrixOrder>[,<matrixOrder>...] <outputFileName> [<debugFlag>]\n",
+            argv[0]
+        );
+        printf("\t-c: count hardware events and print roofline report\n");
+        printf("\t-r: timed solutions for every matrix order (default 1)\n");
+        printf("\t-w: untimed warmup solutions for every matrix order (default 0)\n");
+        printf("\t-b: fail if significantly slower than baseline results\n");
+        printf("\t-e: relative noise band over baseline time (default %.2f)\n", NOISE_BAND);
+        printf("\t-o: solve out of core, streaming grid through <gridFile>\n");
+        printf("\t-f: iterations fused in an out-of-core pass (default %d)\n", FUSED_ITERATIONS);
+        printf("\t-m: problem, grid, dense diagonally dominant Ax=b, sparse Ax=b or\n");
+        printf("\t    active grid skipping settled tiles (default grid), others with no -o or -c\n");
+        printf("\t-M: read sparse matrix from MatrixMarket file, matrix orders are ignored\n\n");
         fflush(stdout);
         exit(EXIT_FAILURE);
     }
-    else if (argc == 3) {
-        n = atoi(argv[1]);
-        output_file = malloc ((strlen(argv[2]) + 1) * sizeof output_file);
-        sprintf(output_file, "%s", argv[2]);
-        debug = 0;
+    // dense, sparse and active-set solutions are in core, with no
+    // hardware counters, only sparse ones may be read from file
+    if (mode != JACOBI_GRID && (opts.grid_file != NULL || opts.counters)) {
+        printf("\aInvalid options: -m %s takes no -o or -c!\n", JACOBI_MODE_NAMES[mode]);
+        exit(EXIT_FAILURE);
     }
-    else {
-        n = atoi(argv[1]);
-        output_file = malloc ((strlen(argv[2]) + 1) * sizeof output_file);
-        sprintf(output_file, "%s", argv[2]);
-        debug = (unsigned char) atoi(argv[3]);
+    if (mode != JACOBI_SPARSE && opts.matrix_file != NULL) {
+        printf("\aInvalid options: -M needs -m sparse!\n");
+        exit(EXIT_FAILURE);
     }
-    printf("Matrix dimension: %dx%d (%d elements)\n", n, n, n*n);
-    printf("\n");
-    fflush(stdout);
+    output_file = opts.output_file;
+    debug = opts.debug;
 
-    // allocate memory for matrix and vectors
-    A = malloc(n * n * sizeof *A);
+    // measure bandwidth ceiling
+    if (opts.counters) {
+        ceiling = stream_triad_bandwidth(1);
+    }
 
-    // generate matrix
-    generate_matrix_array(A, n, n, LOWER_BOUND, UPPER_BOUND, SEED);
+    // a matrix read from file has an order of its own
+    if (opts.matrix_file != NULL) {
+        if (csr_read(&sparse, opts.matrix_file) != 0) {
+            exit(EXIT_FAILURE);
+        }
+        opts.sizes[0] = sparse.rows;
+        opts.size_count = 1;
+    }
 
-    if (debug) {
-        printf("Generated matrix:\n");
-        print_matrix_array(A, n, n);
+    samples = malloc(opts.repetitions * sizeof *samples);
+    if (opts.grid_file != NULL) {
+        solution_file = malloc(strlen(opts.grid_file) + strlen(".solution") + 1);
+        sprintf(solution_file, "%s.solution", opts.grid_file);
+    }
+    for (int s = 0; s < opts.size_count; s++) {
+        n = opts.sizes[s];
+        printf(
+            "Matrix dimension: %dx%d (%zu elements), %d+%d solutions\n",
+            n,
+            n,
+            (size_t) n * n,
+            opts.warmup,
+            opts.repetitions
+        );
         printf("\n");
         fflush(stdout);
-    }
 
-    // apply Jacobi method
-    clock_gettime(CLOCK_REALTIME, &start);
-    num_iterations = jacobi(A, n, n, &err);
-    clock_gettime(CLOCK_REALTIME, &stop);
+        // generate grid file once for every matrix order, never in memory
+        if (solution_file != NULL) {
+            if (ooc_generate(opts.grid_file, n, LOWER_BOUND, UPPER_BOUND, SEED) != 0) {
+                exit(EXIT_FAILURE);
+            }
+            A = A_0 = NULL;
+        } else if (mode == JACOBI_DENSE) {
+            // matrix is left untouched by solution, no need to restore it
+            A = NULL;
+            A_0 = malloc((size_t) n * n * sizeof *A_0);
+            b = malloc(n * sizeof *b);
+            x = malloc(n * sizeof *x);
+            generate_dd_system(A_0, b, n, LOWER_BOUND, UPPER_BOUND, SEED);
+        } else if (mode == JACOBI_SPARSE) {
+            A = A_0 = NULL;
+            b = malloc(n * sizeof *b);
+            x = malloc(n * sizeof *x);
+            if (opts.matrix_file == NULL) {
+                csr_generate(&sparse, n, LOWER_BOUND, UPPER_BOUND, SEED);
+            }
+            csr_system(&sparse, b, LOWER_BOUND, UPPER_BOUND, SEED + 1);
+            nnz = sparse.nnz;
+            printf("Sparse matrix: %zu nonzeros\n", sparse.nnz);
+            printf("\n");
+            fflush(stdout);
+        } else {
+            // allocate memory for matrix and vectors
+            A = malloc((size_t) n * n * sizeof *A);
+            A_0 = malloc((size_t) n * n * sizeof *A_0);
 
-    if (debug) {
-        printf("Resulting matrix:\n");
-        print_matrix_array(A, n, n);
+            // generate matrix once for every matrix order
+            generate_matrix_array(A_0, n, n, LOWER_BOUND, UPPER_BOUND, SEED);
+        }
+
+        if (debug && A_0 != NULL) {
+            printf("Generated matrix:\n");
+            print_matrix_array(A_0, n, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        for (int r = 0; r < opts.warmup + opts.repetitions; r++) {
+            // leave warmup solutions out of counters
+            if (r == opts.warmup && opts.counters) {
+                counters_open();
+            }
+            if (A != NULL) {
+                copy_matrix_array(A_0, A, n, n);
+            }
+
+            // apply Jacobi method
+            clock_gettime(CLOCK_REALTIME, &start);
+            if (solution_file != NULL) {
+                num_iterations = ooc_jacobi(
+                    opts.grid_file, solution_file, n, opts.fused, &err, &ooc_stats
+                );
+            } else if (mode == JACOBI_DENSE) {
+                num_iterations = jacobi_dense(A_0, b, x, n, &err);
+            } else if (mode == JACOBI_SPARSE) {
+                num_iterations = jacobi_sparse(&sparse, b, x, &err);
+            } else if (mode == JACOBI_ACTIVE) {
+                num_iterations = jacobi_active(A, n, n, &err, &active_stats);
+            } else {
+                num_iterations = jacobi(A, n, n, &err);
+            }
+            clock_gettime(CLOCK_REALTIME, &stop);
+            if (num_iterations < 0) {
+                if (mode == JACOBI_SPARSE) {
+                    fprintf(stderr, "\aSparse matrix has a missing or zero diagonal element!\n");
+                }
+                exit(EXIT_FAILURE);
+            }
+
+            elapsedtime = (stop.tv_sec - start.tv_sec) +
+                (stop.tv_nsec - start.tv_nsec) /
+                (double) NS_IN_S;
+            if (r >= opts.warmup) {
+                samples[r - opts.warmup] = elapsedtime;
+            }
+        }
+
+        if (debug && A != NULL) {
+            printf("Resulting matrix:\n");
+            print_matrix_array(A, n, n);
+            printf("\n");
+            fflush(stdout);
+        }
+        if (debug && x != NULL) {
+            printf("Solution:\n");
+            print_matrix_array(x, 1, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        free(A);
+        free(A_0);
+        free(b);
+        free(x);
+        b = x = NULL;
+        if (mode == JACOBI_SPARSE) {
+            csr_free(&sparse);
+        }
+
+        printf("The solution took %d iterations ", num_iterations);
+        printf("and has an error of %.3e.\n", err);
+        if (solution_file != NULL) {
+            printf(
+                "Out-of-core solution in %s: %d passes (%d redone), "
+                "%.1f MiB read, %.1f MiB written, %.1f MiB in memory.\n",
+                solution_file,
+                ooc_stats.passes,
+                ooc_stats.redone,
+                ooc_stats.bytes_read / (1 << 20),
+                ooc_stats.bytes_written / (1 << 20),
+                ooc_stats.window / (1 << 20)
+            );
+        }
+        if (mode == JACOBI_ACTIVE) {
+            printf(
+                "Active set: %.1f%% of cell updates skipped, "
+                "%d of %d tiles frozen, %d woken by neighbours.\n",
+                active_stats.skipped / (active_stats.updated + active_stats.skipped) * 100,
+                active_stats.frozen,
+                active_stats.tiles,
+                active_stats.woken
+            );
+        }
+        fflush(stdout);
+        // if (num_iterations == MAX_ITERATIONS) {
+        //     fprintf(stderr, "\aSolution did not converge!\n");
+        //     exit(EXIT_FAILURE);
+        // }
+
+        // setenv("JACOBI_TIME", elapsedtime, 1); // does not work
+        // write(p[1], elapsedtime, sizeof elapsedtime);
+        summarize_times(samples, opts.repetitions, &time_stats);
+        printf(
+            "Elapsed time: %f ms median, %f ms min, %f ms max.\n",
+            time_stats.median * MS_IN_S,
+            time_stats.min * MS_IN_S,
+            time_stats.max * MS_IN_S
+        );
         printf("\n");
         fflush(stdout);
-    }
 
-    free(A);
+        // check for performance regression
+        if (opts.baseline_file != NULL) {
+            sprintf(label, "n=%d", n);
+            if (baseline_median(opts.baseline_file, n, 0, &baseline) != 0) {
+                printf("%s: no baseline in %s, skipped\n\n", label, opts.baseline_file);
+            } else {
+                check_regression(samples, opts.repetitions, baseline, opts.band, &regression);
+                // a stencil update is 7 operations, a dense or sparse
+                // row is 2 per element, skipped updates are no work
+                if (mode == JACOBI_DENSE) {
+                    flops = 2.0 * n * n * num_iterations;
+                } else if (mode == JACOBI_SPARSE) {
+                    flops = 2.0 * nnz * num_iterations;
+                } else if (mode == JACOBI_ACTIVE) {
+                    flops = 7.0 * active_stats.updated;
+                } else {
+                    flops = 7.0 * (n - 2) * (n - 2) * num_iterations;
+                }
+                regression_print(label, &regression, flops);
+                printf("\n");
+                failed |= regression.regressed;
+            }
+            fflush(stdout);
+        }
 
-    printf("The solution took %d iterations ", num_iterations);
-    printf("and has an error of %.3e.\n", err);
-    fflush(stdout);
-    // if (num_iterations == MAX_ITERATIONS) {
-    //     fprintf(stderr, "\aSolution did not converge!\n");
-    //     exit(EXIT_FAILURE);
-    // }
+        if (opts.counters) {
+            counters_close();
+            counters_report(counters_get(), ceiling);
+            printf("\n");
+            fflush(stdout);
+        }
 
-    elapsedtime = (stop.tv_sec - start.tv_sec) +
-        (stop.tv_nsec - start.tv_nsec) /
-        (double) NS_IN_S;
-    // setenv("JACOBI_TIME", elapsedtime, 1); // does not work
-    // write(p[1], elapsedtime, sizeof elapsedtime);
-    printf("Elapsed time: %f ms.\n", elapsedtime * MS_IN_S);
-    printf("\n");
-    fflush(stdout);
+        printf("Writing result in %s\n", output_file);
+        printf("\n");
+        fflush(stdout);
+        results = fopen(output_file, "a");
+        fprintf(
+            results,
+            "%d,%f,%f,%f\n",
+            n,
+            time_stats.median,
+            time_stats.min,
+            time_stats.max
+        );
+        fflush(results);
+        // close file
+        fclose(results);
+    }
 
-    printf("Writing result in %s\n", output_file);
-    fflush(stdout);
-    results = fopen(output_file, "a");
-    fprintf(results, "%d,%f\n", n, elapsedtime);
-    fflush(results);
-    // close file and get rid of file name
-    fclose(results);
-    free(output_file);
+    // get rid of file name
+    free(samples);
+    free(solution_file);
+    free_options(&opts);
+
+    if (failed) {
+        fprintf(stderr, "\a%s detected a performance regression!\n", argv[0]);
+        return EXIT_FAILURE;
+    }
 
     printf("\n\v%s terminated succesfully!\n", argv[0]);
     return EXIT_SUCCESS;
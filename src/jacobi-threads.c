@@ -0,0 +1,278 @@
+/**
+ * @file jacobi-threads.c
+ * @ingroup runnable
+ * @author Simone Bisogno (bissim.github.io)
+ * @brief Multithreaded shared-memory version of Jacobi method.
+ * @version 0.1.0-rc.4+20200421
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+/**
+ * @brief Use timespec and sysconf definitions from POSIX.
+ *
+ * Use `timespec` and `sysconf` definitions from POSIX.
+ */
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "matrixutils.h"
+#include "bands.h"
+#include "jacobi.h"
+#include "options.h"
+#include "regress.h"
+#include "stats.h"
+#include "misc.h"
+
+/**
+ * @brief How many nanoseconds in a second.
+ *
+ * How many nanoseconds in a second.
+ */
+extern const long NS_IN_S;
+/**
+ * @brief How many milliseconds in a second.
+ */
+extern const int MS_IN_S;
+/**
+ * @brief Minimum double precision floating point number to be generated.
+ */
+extern const double LOWER_BOUND;
+/**
+ * @brief Maximum double precision floating point number to be generated.
+ */
+extern const double UPPER_BOUND;
+
+/**
+ * @brief The main function of Jacobi method in multithreaded version.
+ *
+ * @param argc Count of command-line parameters
+ * @param argv Command-line parameters
+ * @return int Return value indicating whether program execution succeded
+ */
+int main(int argc, char** argv) {
+    // local variables
+    /**
+     * @brief The order of the matrix associated to linear system
+     *
+     */
+    int n;
+    /**
+     * @brief The coefficient matrix in linear system
+     *
+     */
+    double *A;
+    /**
+     * @brief The generated matrix, restored before every solution
+     *
+     */
+    double *A_0;
+    /**
+     * @brief The serial solution, to verify multithreaded one against
+     *
+     */
+    double *reference;
+    int reference_iterations;
+    double reference_err;
+    double max_difference;
+    int threads;
+    int num_iterations = 0;
+    double err = 0.0;
+    double elapsedtime;
+    double *samples;
+    struct time_stats time_stats;
+    struct timespec start, stop;
+    struct bands_stats bands_stats;
+    unsigned char debug = 0;
+    char *output_file;
+    FILE *results;
+    struct options opts;
+    struct regression regression;
+    double baseline;
+    char label[32];
+    int failed = 0;
+
+    printf("Running %s...\n\n\v", argv[0]);
+    fflush(stdout);
+
+    // reading dimension and debug flag from command line
+    if (parse_options(argc, argv, "r:w:Vb:e:t:", &opts) != 0 || opts.threads < 0) {
+        printf("\aInsufficient number of parameters!\n");
+        printf(
+            "Usage: %s [-r <repetitions>] [-w <warmup>] [-V] "
+            "[-b <baselineFile> [-e <band>]] [-t <threads>] "
+            "<matrixOrder>[,<matrixOrder>...] <outputFileName> [<debugFlag>]\n",
+            argv[0]
+        );
+        printf("\t-r: timed solutions for every matrix order (default 1)\n");
+        printf("\t-w: untimed warmup solutions for every matrix order (default 0)\n");
+        printf("\t-V: fail if solution differs from serial one\n");
+        printf("\t-b: fail if significantly slower than baseline results\n");
+        printf("\t-e: relative noise band over baseline time (default %.2f)\n", NOISE_BAND);
+        printf("\t-t: threads (default one per online CPU)\n\n");
+        fflush(stdout);
+        exit(EXIT_FAILURE);
+    }
+    output_file = opts.output_file;
+    debug = opts.debug;
+    threads = (opts.threads > 0)? opts.threads: (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    samples = malloc(opts.repetitions * sizeof *samples);
+    for (int s = 0; s < opts.size_count; s++) {
+        n = opts.sizes[s];
+        printf(
+            "Matrix dimension: %dx%d (%zu elements), %d+%d solutions over %d threads\n",
+            n,
+            n,
+            (size_t) n * n,
+            opts.warmup,
+            opts.repetitions,
+            threads
+        );
+        printf("\n");
+        fflush(stdout);
+
+        // allocate memory for matrix and generate it once
+        // for every matrix order
+        A = malloc((size_t) n * n * sizeof *A);
+        A_0 = malloc((size_t) n * n * sizeof *A_0);
+        generate_matrix_array(A_0, n, n, LOWER_BOUND, UPPER_BOUND, SEED);
+
+        if (debug) {
+            printf("Generated matrix:\n");
+            print_matrix_array(A_0, n, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        for (int r = 0; r < opts.warmup + opts.repetitions; r++) {
+            copy_matrix_array(A_0, A, n, n);
+
+            // apply Jacobi method
+            clock_gettime(CLOCK_REALTIME, &start);
+            num_iterations = bands_jacobi(A, n, threads, &err, &bands_stats);
+            clock_gettime(CLOCK_REALTIME, &stop);
+            if (num_iterations < 0) {
+                fprintf(stderr, "\aCannot start %d threads!\n", threads);
+                exit(EXIT_FAILURE);
+            }
+
+            elapsedtime = (stop.tv_sec - start.tv_sec) +
+                (stop.tv_nsec - start.tv_nsec) /
+                (double) NS_IN_S;
+            if (r >= opts.warmup) {
+                samples[r - opts.warmup] = elapsedtime;
+            }
+        }
+
+        if (debug) {
+            printf("Resulting matrix:\n");
+            print_matrix_array(A, n, n);
+            printf("\n");
+            fflush(stdout);
+        }
+
+        printf("The solution took %d iterations ", num_iterations);
+        printf("and has an error of %.3e.\n", err);
+        printf(
+            "%d threads, %d iterations at most thrown away past convergence, "
+            "%.3f ms at most waiting for neighbours.\n",
+            bands_stats.threads,
+            bands_stats.wasted,
+            bands_stats.wait_seconds * MS_IN_S
+        );
+        summarize_times(samples, opts.repetitions, &time_stats);
+        printf(
+            "Elapsed time: %f ms median, %f ms min, %f ms max.\n",
+            time_stats.median * MS_IN_S,
+            time_stats.min * MS_IN_S,
+            time_stats.max * MS_IN_S
+        );
+        printf("\n");
+        fflush(stdout);
+
+        // solve the same matrix serially and compare
+        if (opts.verify) {
+            reference = malloc((size_t) n * n * sizeof *reference);
+            copy_matrix_array(A_0, reference, n, n);
+            reference_iterations = jacobi(reference, n, n, &reference_err);
+            if (verify_solution(A, reference, n, n, VERIFY_TOLERANCE, &max_difference) &&
+                reference_iterations == num_iterations) {
+                printf(
+                    "n=%d: solution matches serial one (max difference %.3e)\n",
+                    n,
+                    max_difference
+                );
+            } else {
+                printf(
+                    "n=%d: MISMATCH, %d iterations against %d serial ones, "
+                    "max difference %.3e over %.3e\n",
+                    n,
+                    num_iterations,
+                    reference_iterations,
+                    max_difference,
+                    VERIFY_TOLERANCE
+                );
+                failed = 1;
+            }
+            printf("\n");
+            fflush(stdout);
+            free(reference);
+        }
+
+        free(A);
+        free(A_0);
+
+        // check for performance regression
+        if (opts.baseline_file != NULL) {
+            sprintf(label, "n=%d t=%d", n, threads);
+            if (baseline_median(opts.baseline_file, n, threads, &baseline) != 0) {
+                printf("%s: no baseline in %s, skipped\n\n", label, opts.baseline_file);
+            } else {
+                check_regression(samples, opts.repetitions, baseline, opts.band, &regression);
+                regression_print(label, &regression, 7.0 * (n - 2) * (n - 2) * num_iterations);
+                printf("\n");
+                failed |= regression.regressed;
+            }
+            fflush(stdout);
+        }
+
+        printf("Writing result in %s\n", output_file);
+        printf("\n");
+        fflush(stdout);
+        results = fopen(output_file, "a");
+        fprintf(
+            results,
+            "%d,%f,%f,%f,%d\n",
+            threads,
+            time_stats.median,
+            time_stats.min,
+            time_stats.max,
+            n
+        );
+        fflush(results);
+        // close file
+        fclose(results);
+    }
+
+    // get rid of file name
+    free(samples);
+    free_options(&opts);
+
+    if (failed) {
+        fprintf(stderr, "\a%s failed verification or regression check!\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("\n\v%s terminated succesfully!\n", argv[0]);
+    return EXIT_SUCCESS;
+}
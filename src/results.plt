@@ -37,8 +37,13 @@ if (type eq "serial") {
             xequiv = 4
             yequiv = 1
         } else {
-            print "Unknown type: ", type
-            exit
+            if (type eq "parallel efficiency") {
+                xequiv = 4
+                yequiv = 1
+            } else {
+                print "Unknown type: ", type
+                exit
+            }
         }
     }
 }
@@ -59,7 +64,7 @@ if (type eq "serial") {
         set xtics 2 rotate by -45
         set ytics 10
     } else {
-        if (type eq "parallel weak scaling") {
+        if (type eq "parallel weak scaling" || type eq "parallel efficiency") {
             set xtics 2 rotate by -45
             set ytics 0.5
         }
@@ -71,7 +76,7 @@ set xrange [GPVAL_DATA_X_MIN:GPVAL_DATA_X_MAX]
 set yrange [GPVAL_DATA_Y_MIN:GPVAL_DATA_Y_MAX]
 
 # format y labels
-if (type eq "parallel weak scaling") {
+if (type eq "parallel weak scaling" || type eq "parallel efficiency") {
     set format y "%.1f"
 }
 
@@ -84,7 +89,11 @@ if (type eq "serial") {
 } else {
     set xlabel "Number of processors"
 }
-set ylabel "Time (s)"
+if (type eq "parallel efficiency") {
+    set ylabel "Speedup, efficiency, Karp-Flatt metric"
+} else {
+    set ylabel "Time (s)"
+}
 
 # grid style
 set style line 1 lt 1 lw 0.5 lc rgb "#C0C0C0"
@@ -99,10 +108,17 @@ set style line 3 lw 2 lc black pt 0
 set style line 4 lw 1 lc rgb "red" dt 4
 
 # plot provided data with specified settings
+if (type eq "parallel efficiency") {
+    set yrange [0:GPVAL_DATA_Y_MAX > 1? GPVAL_DATA_Y_MAX: 1]
+    plot results using 1:2 ls 2, \
+        "" using 1:3 lw 2 lc black, \
+        "" using 1:4 ls 4
+} else {
 plot results ls 2, \
     "" notitle with yerrorbars ls 3, \
     results using 1:2:(sprintf("%.2f", $2)) with labels offset char 1, 1 notitle#, \
 #    "" smooth bezier title "Bezier" with lines ls 4
+}
 
 # save plot to image
 plotImageName = "./doc/img/results-" . type . ".png"